@@ -1,6 +1,6 @@
 /**
  * MAX31329 Alarm1 interrupt demo: configures Alarm1 to trigger every minute using hardware interrupts.
- * Uses low-level register access to set alarm masks and GPIO interrupt handling on ESP32-S3.
+ * Uses the typed alarm API and GPIO interrupt handling on ESP32-S3.
  * Prints timestamped alarm notifications when interrupt occurs.
  */
 /* ───────── KODE | docs.kode.diy ───────── */
@@ -42,22 +42,8 @@ void setup()
 	/* Enable Alarm1 interrupt in RTC */
 	rtc.enableInterrupts(MAX31329_INT_A1IE);
 
-	/* Configure Alarm1 to trigger every minute using register masks */
-	uint8_t regs[6] = {0};
-	/* Set all mask bits to 1 for "every minute" trigger - when mask=1, field is ignored */
-	regs[0] = 0x80; /* A1M1 (seconds mask) - ignore seconds */
-	regs[1] = 0x80; /* A1M2 (minutes mask) - ignore minutes */
-	regs[2] = 0x80; /* A1M3 (hours mask) - ignore hours */
-	regs[3] = 0x80; /* A1M4 (day/date mask) - ignore day/date */
-	
-	/* Write alarm1 registers: SEC, MIN, HRS, DAY_DATE */
-	rtc.writeBytes(MAX31329_REG_ALM1_SEC, regs, 4);
-	
-	/* Configure month and year alarm registers */
-	uint8_t mon = 0x80;  /* A1M5 (month mask) - ignore month */
-	uint8_t year = 0x00; /* Year value (A1M6 handled separately) */
-	rtc.writeBytes(MAX31329_REG_ALM1_MON, &mon, 1);
-	rtc.writeBytes(MAX31329_REG_ALM1_YEAR, &year, 1);
+	/* Configure Alarm1 to trigger every minute, when seconds match 00 */
+	rtc.setAlarm1(MAX31329_Alarm1::atSecond(0));
 
 	/* Clear any pending alarm flags */
 	rtc.clearStatus();
@@ -43,8 +43,7 @@ void setup()
 	rtc.enableInterrupts(MAX31329_INT_A2IE);
 
 	/* Configure Alarm2 for every minute - Alarm2 only has MIN/HRS/DAY_DATE fields */
-	uint8_t regs[3] = {0x80, 0x80, 0x80}; /* A2M2, A2M3, A2M4 masks set to ignore all fields */
-	rtc.writeBytes(MAX31329_REG_ALM2_MIN, regs, sizeof(regs));
+	rtc.setAlarm2(MAX31329_Alarm2::everyMinute());
 
 	/* Clear any pending alarm flags before starting */
 	rtc.clearStatus();
@@ -0,0 +1,194 @@
+/**
+ * MAX31329 hot-path benchmark: times the pure conversions, counts I2C transactions and bytes
+ * per public API call, and measures end-to-end alarm rearm and NVRAM update latency.
+ * Prints one JSON object per line with a regression threshold and a pass flag, then a summary.
+ * Build with -DKODE_MAX31329_STATS=1 for the transaction counts (skipped otherwise).
+ * Alarm1, INT_EN and NVRAM offsets 32..63 are saved first and restored at the end; the
+ * current time is written back unchanged. STATUS is read, which clears latched flags.
+ * The host build runs this sketch on the simulated device and keeps the JSON lines in
+ * Benchmark.json in the build directory; conversions are skipped there (virtual clock,
+ * see extras/bench/bench_epoch.cpp).
+ */
+/* ───────── KODE | docs.kode.diy ───────── */
+
+#include <kode_MAX31329.h>
+#include <MAX31329_nvstore.h>
+
+MAX31329 rtc;
+
+/* Regression thresholds - tighten these once a baseline has been recorded */
+static const float LIMIT_BCD_NS = 100.0f;        /* bcdToBin + binToBcd round trip */
+static const float LIMIT_TM_NS = 1500.0f;        /* MAX31329_Time::toTm + fromTm */
+static const float LIMIT_EPOCH_NS = 2000.0f;     /* timeToEpoch + epochToTime */
+static const float LIMIT_ALARM_REARM_US = 1000.0f;
+static const float LIMIT_NV_UPDATE_US = 2000.0f;
+
+static const int ITERATIONS = 10000;
+static int failures = 0;
+static volatile uint32_t sink; /* keeps the optimizer from dropping the loops */
+
+/* Device state the benchmark overwrites */
+static uint8_t savedAlarm1[6];
+static uint8_t savedIntEn;
+static uint8_t savedRam[32];
+
+/* One result line: {"bench":...,"unit":...,"value":...,"limit":...,"pass":...} */
+static void report(const char *bench, const char *unit, float value, float limit)
+{
+	bool pass = value <= limit;
+	if (!pass) failures++;
+	Serial.printf("{\"bench\":\"%s\",\"unit\":\"%s\",\"value\":%.2f,\"limit\":%.2f,\"pass\":%s}\n",
+		bench, unit, value, limit, pass ? "true" : "false");
+}
+
+static void benchConversions()
+{
+#if defined(KODE_MAX31329_HOST)
+	/* micros() is the simulator's virtual clock: it does not move while the CPU works */
+	Serial.println("{\"skipped\":\"conversions\",\"reason\":\"virtual clock\"}");
+	return;
+#endif
+	uint32_t t0 = micros();
+	for (int i = 0; i < ITERATIONS; i++) {
+		sink = sink + MAX31329::bcdToBin(MAX31329::binToBcd((uint8_t)(i % 100)));
+	}
+	report("bcd_roundtrip", "ns/op", (micros() - t0) * 1000.0f / ITERATIONS, LIMIT_BCD_NS);
+
+	MAX31329_Time t;
+	MAX31329::epochToTime(1760000000, t);
+	struct tm tm;
+	t0 = micros();
+	for (int i = 0; i < ITERATIONS; i++) {
+		t.toTm(tm);
+		tm.tm_sec = i % 60;
+		t.fromTm(tm);
+		sink = sink + t.second;
+	}
+	report("time_tm_roundtrip", "ns/op", (micros() - t0) * 1000.0f / ITERATIONS, LIMIT_TM_NS);
+
+	t0 = micros();
+	for (int i = 0; i < ITERATIONS; i++) {
+		MAX31329::epochToTime(1760000000 + (int64_t)i * 86399, t);
+		sink = sink + (uint32_t)MAX31329::timeToEpoch(t);
+	}
+	report("time_epoch_roundtrip", "ns/op", (micros() - t0) * 1000.0f / ITERATIONS, LIMIT_EPOCH_NS);
+}
+
+#if KODE_MAX31329_STATS
+/* Transactions and bytes per call of one public API entry point */
+static void reportOp(MAX31329_Op op, const char *bench, float maxTransactions, float maxBytes)
+{
+	MAX31329_Stats st;
+	rtc.statsSnapshot(st);
+	const MAX31329_OpStats &o = st.ops[op];
+	if (o.calls == 0) return;
+	char name[48];
+	snprintf(name, sizeof(name), "%s_txn", bench);
+	report(name, "txn/call", (float)o.transactions / o.calls, maxTransactions);
+	snprintf(name, sizeof(name), "%s_bytes", bench);
+	report(name, "bytes/call", (float)o.bytes / o.calls, maxBytes);
+}
+
+static void benchBusUsage()
+{
+	const int calls = 20;
+	rtc.statsReset();
+	for (int i = 0; i < calls; i++) rtc.readTime();
+	for (int i = 0; i < calls; i++) rtc.writeTime();   /* writes back what was just read */
+	uint8_t st;
+	for (int i = 0; i < calls; i++) rtc.readStatus(st);
+	for (int i = 0; i < calls; i++) rtc.enableInterrupts(MAX31329_INT_A1IE);
+	for (int i = 0; i < calls; i++) rtc.setAlarm1(MAX31329_Alarm1::atSecond((uint8_t)i));
+	MAX31329_Snapshot snap;
+	for (int i = 0; i < calls; i++) rtc.snapshot(snap);
+
+	reportOp(MAX31329_OP_READ_TIME, "readTime", 1, 8);
+	reportOp(MAX31329_OP_WRITE_TIME, "writeTime", 1, 8);
+	reportOp(MAX31329_OP_READ_STATUS, "readStatus", 1, 2);
+	reportOp(MAX31329_OP_ENABLE_INTERRUPTS, "enableInterrupts", 2, 4);
+	reportOp(MAX31329_OP_SET_ALARM, "setAlarm1", 1, 7);
+	reportOp(MAX31329_OP_SNAPSHOT, "snapshot", 1, 27);
+}
+#endif
+
+static void benchFlows()
+{
+	/* Alarm rearm: what a scheduler does after every wake */
+	const int rounds = 50;
+	uint32_t worst = 0;
+	for (int i = 0; i < rounds; i++) {
+		uint32_t t0 = micros();
+		rtc.setAlarm1(MAX31329_Alarm1::atHour((uint8_t)(i % 24), 0, 0));
+		uint32_t dt = micros() - t0;
+		if (dt > worst) worst = dt;
+	}
+	report("alarm_rearm_worst", "us", (float)worst, LIMIT_ALARM_REARM_US);
+
+	/* NVRAM update: bump a counter in the key/value store and commit */
+	MAX31329_NvStore nv(rtc, 32, 32);
+	nv.load();
+	worst = 0;
+	size_t bytes = 0;
+	for (int i = 0; i < rounds; i++) {
+		uint32_t counter = 0;
+		nv.get(1, counter);
+		counter++;
+		nv.put(1, counter);
+		uint32_t t0 = micros();
+		nv.commit(&bytes);
+		uint32_t dt = micros() - t0;
+		if (dt > worst) worst = dt;
+	}
+	report("nv_update_worst", "us", (float)worst, LIMIT_NV_UPDATE_US);
+	report("nv_update_bytes", "bytes", (float)bytes, 8.0f);
+}
+
+static bool saveState()
+{
+	return rtc.readBytes(MAX31329_REG_ALM1_SEC, savedAlarm1, sizeof(savedAlarm1)) &&
+		rtc.readBytes(MAX31329_REG_INT_EN, &savedIntEn, 1) &&
+		rtc.readRam(32, savedRam, sizeof(savedRam));
+}
+
+static bool restoreState()
+{
+	return rtc.writeBytes(MAX31329_REG_ALM1_SEC, savedAlarm1, sizeof(savedAlarm1)) &&
+		rtc.writeBytes(MAX31329_REG_INT_EN, &savedIntEn, 1) &&
+		rtc.writeRam(32, savedRam, sizeof(savedRam));
+}
+
+void setup()
+{
+	Serial.begin(115200);
+	Serial.println("{\"example\":\"MAX31329 Benchmark\"}");
+
+	/* Initialize RTC - configure Wire.begin(48,47) for kode dot hardware */
+	if (!rtc.begin()) {
+		Serial.println("{\"summary\":\"FAIL\",\"error\":\"begin\"}");
+		return;
+	}
+	if (!saveState()) {
+		Serial.println("{\"summary\":\"FAIL\",\"error\":\"save\"}");
+		return;
+	}
+	rtc.readTime();
+
+	benchConversions();
+#if KODE_MAX31329_STATS
+	benchBusUsage();
+#else
+	Serial.println("{\"skipped\":\"bus_usage\",\"reason\":\"KODE_MAX31329_STATS=0\"}");
+#endif
+	benchFlows();
+
+	if (!restoreState()) {
+		Serial.println("{\"summary\":\"FAIL\",\"error\":\"restore\"}");
+		return;
+	}
+	Serial.printf("{\"summary\":\"%s\",\"failed\":%d}\n", failures ? "FAIL" : "PASS", failures);
+}
+
+void loop()
+{
+	delay(1000);
+}
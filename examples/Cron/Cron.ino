@@ -0,0 +1,71 @@
+/**
+ * MAX31329 cron demo: compiles a cron expression onto the RTC alarms so the MCU only wakes for matches.
+ * Every 15 minutes from 08:00 to 18:45, Monday to Friday, cannot be expressed by an alarm mask,
+ * so Alarm2 is pointed at each next match and moved on after every wake.
+ */
+/* ───────── KODE | docs.kode.diy ───────── */
+
+#include <kode_MAX31329.h>
+#include <MAX31329_cron.h>
+
+MAX31329 rtc;
+MAX31329_Cron cron;
+volatile bool alarmFlag = false;
+const int pinInterrupt = 2; /* GPIO pin connected to MAX31329 INT output - adjust for your board */
+
+/* Interrupt Service Routine - must be in IRAM for ESP32-S3 */
+static void IRAM_ATTR onInterrupt()
+{
+	alarmFlag = true;
+}
+
+void setup()
+{
+	Serial.begin(115200);
+	Serial.println("MAX31329 Cron example");
+
+	/* Configure interrupt pin and attach ISR */
+	pinMode(pinInterrupt, INPUT);
+	attachInterrupt(digitalPinToInterrupt(pinInterrupt), onInterrupt, FALLING);
+
+	/* Initialize RTC - configure Wire.begin(48,47) for kode dot hardware */
+	rtc.begin();
+
+	/* Monday 2024-11-25 08:59:50 */
+	rtc.t.year = 2024;
+	rtc.t.month = 11;
+	rtc.t.day = 25;
+	rtc.t.hour = 8;
+	rtc.t.minute = 59;
+	rtc.t.second = 50;
+	rtc.t.dayOfWeek = 1;
+	rtc.writeTime();
+
+	if (!cron.parse("*/15 8-18 * * 1-5")) {
+		Serial.println("bad cron expression");
+		return;
+	}
+	Serial.printf("mask plan: Alarm%d, %s\n", cron.alarmUsed(),
+		cron.exact() ? "exact" : "needs filter, arming next match");
+
+	/* Clear any pending alarm flags, then program the alarm and its interrupt */
+	rtc.clearStatus();
+	cron.arm(rtc);
+}
+
+void loop()
+{
+	if (alarmFlag) {
+		alarmFlag = false;
+
+		uint8_t st;
+		if (rtc.readStatus(st) && (st & (MAX31329_STATUS_A1F | MAX31329_STATUS_A2F))) {
+			/* service() filters the wake and rearms for the next match */
+			if (cron.service(rtc) && rtc.readTime()) {
+				Serial.printf("CRON: %04d-%02d-%02d %02d:%02d:%02d\n",
+					rtc.t.year, rtc.t.month, rtc.t.day,
+					rtc.t.hour, rtc.t.minute, rtc.t.second);
+			}
+		}
+	}
+}
@@ -1,20 +1,33 @@
 /**
  * MAX31329 Timer interrupt demo: configures countdown timer to trigger at 16Hz with auto-repeat.
  * Uses hardware timer functionality with interrupt handling for precise timing on ESP32-S3.
- * Demonstrates periodic timer events with timestamped notifications.
+ * Demonstrates periodic timer events dispatched with a single STATUS read per interrupt.
  */
 /* ───────── KODE | docs.kode.diy ───────── */
 
 #include <kode_MAX31329.h>
+#include <MAX31329_events.h>
 
 MAX31329 rtc;
-volatile bool timerFlag = false;
+MAX31329_Events events(rtc);
 const int pinInterrupt = 2; /* GPIO pin connected to MAX31329 timer interrupt output */
 
-/* Timer Interrupt Service Routine - must be in IRAM for ESP32-S3 */
+/* Timer Interrupt Service Routine - must be in IRAM for ESP32-S3, no I2C here */
 static void IRAM_ATTR onInterrupt()
 {
-	timerFlag = true;
+	events.notifyFromISR();
+}
+
+/* Runs from loop() when STATUS shows TIF - timer auto-restarts due to repeat=true */
+static void onTimer(uint8_t flag, uint32_t edges, void *arg)
+{
+	/* Read and display current time when timer fires */
+	if (rtc.readTime()) {
+		Serial.printf("TIMER: %04d-%02d-%02d %02d:%02d:%02d (edges=%u, max latency=%uus)\n",
+			rtc.t.year, rtc.t.month, rtc.t.day,
+			rtc.t.hour, rtc.t.minute, rtc.t.second,
+			(unsigned)edges, (unsigned)events.maxLatencyUs());
+	}
 }
 
 void setup()
@@ -44,6 +57,9 @@ void setup()
 		Serial.println("timerConfigure failed");
 	}
 	
+	/* Handle the Timer Interrupt Flag from loop() */
+	events.on(MAX31329_STATUS_TIF, onTimer);
+
 	/* Enable timer interrupt in RTC */
 	rtc.enableInterrupts(MAX31329_INT_TIE);
 
@@ -53,21 +69,6 @@ void setup()
 
 void loop()
 {
-	/* Handle timer interrupt when it occurs */
-	if (timerFlag) {
-		timerFlag = false;  /* Reset interrupt flag */
-		
-		uint8_t st;
-		/* Verify Timer Interrupt Flag is set in status register */
-		if (rtc.readStatus(st) && (st & MAX31329_STATUS_TIF)) {
-			/* Read and display current time when timer fires */
-			if (rtc.readTime()) {
-				Serial.printf("TIMER: %04d-%02d-%02d %02d:%02d:%02d\n",
-					rtc.t.year, rtc.t.month, rtc.t.day,
-					rtc.t.hour, rtc.t.minute, rtc.t.second);
-			}
-			/* Clear timer interrupt flag - timer auto-restarts due to repeat=true */
-			rtc.clearStatus();
-		}
-	}
+	/* Reads (and thereby clears) STATUS once, then calls the handlers */
+	events.dispatch();
 }
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host microbenchmark of the direct epoch conversions against the struct tm
+// route they replace (toTm() + mktime(), gmtime_r() + fromTm()), timed on
+// the host's steady clock:
+//
+//   bench_epoch [output-file]
+//
+// One JSON object per line as in examples/Benchmark, then a summary; a
+// result passes when the direct conversion beats the libc route.
+
+#include <kode_MAX31329.h>
+
+#include <chrono>
+#include <stdlib.h>
+
+static const int ITERATIONS = 1000000;
+static volatile int64_t sink; // keeps the optimizer from dropping the loops
+static FILE *out = nullptr;
+static int failures = 0;
+
+static double nowNs() {
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void report(const char *bench, double value, double limit) {
+	bool pass = value <= limit;
+	if (!pass) failures++;
+	char line[160];
+	snprintf(line, sizeof(line), "{\"bench\":\"%s\",\"unit\":\"ns/op\",\"value\":%.2f,\"limit\":%.2f,\"pass\":%s}\n",
+		bench, value, limit, pass ? "true" : "false");
+	fputs(line, stdout);
+	if (out) fputs(line, out);
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1 && !(out = fopen(argv[1], "w"))) {
+		perror(argv[1]);
+		return 2;
+	}
+	setenv("TZ", "UTC", 1);
+	tzset();
+
+	// Time -> epoch
+	MAX31329_Time t;
+	struct tm tm;
+	double t0 = nowNs();
+	for (int i = 0; i < ITERATIONS; i++) {
+		t.toTm(tm);
+		tm.tm_sec = i % 60;
+		sink = sink + (int64_t)mktime(&tm);
+	}
+	double libc = (nowNs() - t0) / ITERATIONS;
+	t0 = nowNs();
+	for (int i = 0; i < ITERATIONS; i++) {
+		t.second = i % 60;
+		sink = sink + MAX31329::timeToEpoch(t);
+	}
+	double direct = (nowNs() - t0) / ITERATIONS;
+	report("toTm_mktime", libc, libc);
+	report("timeToEpoch", direct, libc);
+
+	// Epoch -> time
+	t0 = nowNs();
+	for (int i = 0; i < ITERATIONS; i++) {
+		time_t e = (time_t)(1760000000 + (int64_t)i * 86399);
+		gmtime_r(&e, &tm);
+		t.fromTm(tm);
+		sink = sink + t.second;
+	}
+	libc = (nowNs() - t0) / ITERATIONS;
+	t0 = nowNs();
+	for (int i = 0; i < ITERATIONS; i++) {
+		MAX31329::epochToTime(1760000000 + (int64_t)i * 86399, t);
+		sink = sink + t.second;
+	}
+	direct = (nowNs() - t0) / ITERATIONS;
+	report("gmtime_fromTm", libc, libc);
+	report("epochToTime", direct, libc);
+
+	char line[64];
+	snprintf(line, sizeof(line), "{\"summary\":\"%s\",\"failed\":%d}\n", failures ? "FAIL" : "PASS", failures);
+	fputs(line, stdout);
+	if (out) {
+		fputs(line, out);
+		fclose(out);
+	}
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "MAX31329_sim.h"
+
+HardwareSerial Serial;
+
+struct HostPin {
+	uint8_t mode = INPUT;
+	uint8_t out = HIGH;
+	int8_t driven = -1;   // level forced from outside, -1 none
+	void (*isr)(void) = nullptr;
+	int isrMode = 0;
+};
+
+static HostPin pins[HOST_PINS];
+
+unsigned long micros() {
+	return (unsigned long)MAX31329_SimClock::now();
+}
+
+unsigned long millis() {
+	return (unsigned long)(MAX31329_SimClock::now() / 1000);
+}
+
+void delay(uint32_t ms) {
+	MAX31329_SimClock::advance((int64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+	MAX31329_SimClock::advance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+	if (pin < HOST_PINS) pins[pin].mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+	if (pin >= HOST_PINS) return;
+	pins[pin].out = value ? HIGH : LOW;
+	TwoWire::lineWritten(pin, pins[pin].out);
+}
+
+// Inputs read the driven level or the pull-up; open drain is a wired AND
+static int level(uint8_t pin) {
+	const HostPin &p = pins[pin];
+	int outside = TwoWire::lineLevel(pin);
+	if (outside < 0) outside = p.driven;
+	if (p.mode == OUTPUT) return p.out;
+	if (p.mode == OUTPUT_OPEN_DRAIN) return (p.out && outside != LOW) ? HIGH : LOW;
+	return outside < 0 ? HIGH : outside;
+}
+
+int digitalRead(uint8_t pin) {
+	return pin < HOST_PINS ? level(pin) : LOW;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+	if (pin >= HOST_PINS) return;
+	pins[pin].isr = isr;
+	pins[pin].isrMode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+	if (pin < HOST_PINS) pins[pin].isr = nullptr;
+}
+
+void hostDrivePin(uint8_t pin, int value) {
+	if (pin >= HOST_PINS) return;
+	int before = level(pin);
+	pins[pin].driven = value ? HIGH : LOW;
+	int after = level(pin);
+	HostPin &p = pins[pin];
+	if (before == after || !p.isr) return;
+	if (p.isrMode == CHANGE || (p.isrMode == FALLING && after == LOW) ||
+		(p.isrMode == RISING && after == HIGH)) {
+		p.isr();
+	}
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+	return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *data, size_t length) {
+	fwrite(data, 1, length, stdout);
+	if (mirror) fwrite(data, 1, length, mirror);
+	return length;
+}
+
+size_t HardwareSerial::print(const char *s) {
+	return write((const uint8_t *)s, strlen(s));
+}
+
+size_t HardwareSerial::print(char c) {
+	return write((uint8_t)c);
+}
+
+size_t HardwareSerial::print(long v, int base) {
+	return base == HEX ? printf("%lX", (unsigned long)v) : printf("%ld", v);
+}
+
+size_t HardwareSerial::print(unsigned long v, int base) {
+	return base == HEX ? printf("%lX", v) : printf("%lu", v);
+}
+
+size_t HardwareSerial::print(double v, int digits) {
+	return printf("%.*f", digits, v);
+}
+
+size_t HardwareSerial::println() {
+	return print("\r\n");
+}
+
+size_t HardwareSerial::printf(const char *format, ...) {
+	char buf[256];
+	va_list args;
+	va_start(args, format);
+	int n = vsnprintf(buf, sizeof(buf), format, args);
+	va_end(args);
+	if (n < 0) return 0;
+	return write((const uint8_t *)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
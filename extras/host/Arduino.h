@@ -0,0 +1,103 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_HOST_ARDUINO_H
+#define KODE_MAX31329_HOST_ARDUINO_H
+
+// Minimal Arduino core for host builds (KODE_MAX31329_HOST). Time runs on the
+// simulator's virtual clock, pins are a table whose inputs can be driven from
+// outside (hostDrivePin), and Serial prints to stdout.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH               0x1
+#define LOW                0x0
+
+#define INPUT              0x01
+#define OUTPUT             0x03
+#define INPUT_PULLUP       0x05
+#define OUTPUT_OPEN_DRAIN  0x13
+
+#define RISING             0x01
+#define FALLING            0x02
+#define CHANGE             0x03
+
+#define DEC                10
+#define HEX                16
+
+// ESP32-S3 default I2C pins
+#define SDA                8
+#define SCL                9
+
+#define IRAM_ATTR
+#define digitalPinToInterrupt(p) (p)
+
+#define HOST_PINS          64
+
+unsigned long micros();
+unsigned long millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+// Host side: an external driver (a simulated device) sets an input level.
+// Edges matching the attached interrupt mode call the ISR.
+void hostDrivePin(uint8_t pin, int level);
+
+class HardwareSerial {
+public:
+	void begin(unsigned long baud) { (void)baud; }
+	void end() {}
+	void flush() { fflush(stdout); }
+	int available() { return 0; }
+	int read() { return -1; }
+	operator bool() const { return true; }
+
+	size_t write(uint8_t c);
+	size_t write(const uint8_t *data, size_t length);
+	size_t print(const char *s);
+	size_t print(char c);
+	size_t print(long v, int base = DEC);
+	size_t print(unsigned long v, int base = DEC);
+	size_t print(int v, int base = DEC) { return print((long)v, base); }
+	size_t print(unsigned v, int base = DEC) { return print((unsigned long)v, base); }
+	size_t print(double v, int digits = 2);
+	size_t println();
+	template <typename T> size_t println(T v) { return print(v) + println(); }
+	template <typename T> size_t println(T v, int arg) { return print(v, arg) + println(); }
+	size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+	// Host side: also copy everything printed to `file` (nullptr stops)
+	void tee(FILE *file) { mirror = file; }
+
+private:
+	FILE *mirror = nullptr;
+};
+
+extern HardwareSerial Serial;
+
+#endif // KODE_MAX31329_HOST_ARDUINO_H
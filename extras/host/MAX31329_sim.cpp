@@ -0,0 +1,488 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_sim.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#include <atomic>
+
+static std::atomic<int64_t> clockUs(1000000);
+static MAX31329_Sim *devices = nullptr;
+
+int64_t MAX31329_SimClock::now() {
+	return clockUs.load();
+}
+
+void MAX31329_SimClock::advance(int64_t us) {
+	if (us <= 0) return;
+	clockUs += us;
+	MAX31329_Sim::syncAll();
+}
+
+void MAX31329_SimClock::reset(int64_t us) {
+	clockUs = us;
+	MAX31329_Sim::syncAll();
+}
+
+// 2000-01-01 00:00:00, the register reset value
+static const int64_t EPOCH_2000 = 946684800;
+
+static uint8_t toBcd(int v) { return (uint8_t)(((v / 10) << 4) | (v % 10)); }
+static int fromBcd(uint8_t v) { return (v >> 4) * 10 + (v & 0x0F); }
+
+static int64_t floorDiv(int64_t a, int64_t b) {
+	int64_t q = a / b;
+	return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant)
+static int32_t daysFromCivil(int y, unsigned m, unsigned d) {
+	y -= m <= 2;
+	const int era = (y >= 0 ? y : y - 399) / 400;
+	const unsigned yoe = (unsigned)(y - era * 400);
+	const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + (int32_t)doe - 719468;
+}
+
+static void civilFromDays(int32_t z, int &y, unsigned &m, unsigned &d) {
+	z += 719468;
+	const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+	const unsigned doe = (unsigned)(z - era * 146097);
+	const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const unsigned mp = (5 * doy + 2) / 153;
+	d = doy - (153 * mp + 2) / 5 + 1;
+	m = mp < 10 ? mp + 3 : mp - 9;
+	y = (int)yoe + era * 400 + (m <= 2);
+}
+
+struct SimFields {
+	int sec, min, hour, day, date, month, year; // day: 1 = Sunday
+};
+
+static void fieldsOf(int64_t epoch, SimFields &f) {
+	int64_t days = floorDiv(epoch, 86400);
+	int64_t sod = epoch - days * 86400;
+	int y;
+	unsigned m, d;
+	civilFromDays((int32_t)days, y, m, d);
+	f.sec = (int)(sod % 60);
+	f.min = (int)(sod / 60 % 60);
+	f.hour = (int)(sod / 3600);
+	f.day = (int)(((days + 4) % 7 + 7) % 7) + 1;
+	f.date = (int)d;
+	f.month = (int)m;
+	f.year = y;
+}
+
+MAX31329_Sim::MAX31329_Sim(uint8_t address)
+	: addr(address), pointer(0), secs(EPOCH_2000), phaseUs(0), timerPhase(0), ppm(0),
+	  lastUs(MAX31329_SimClock::now()), pfail(false), intLevel(false), intPin(-1),
+	  fault(MAX31329_SIM_FAULT_NONE), faultCount(0), faultSkip(0), shortPending(false),
+	  tearBytes(0), tearSkip(0), tearArmed(false), stuckClocks(0), next(nullptr)
+{
+	memset(regs, 0, sizeof(regs));
+	powerOn();
+	MAX31329_Sim **p = &devices;
+	while (*p) p = &(*p)->next;
+	*p = this;
+}
+
+MAX31329_Sim::~MAX31329_Sim() {
+	for (MAX31329_Sim **p = &devices; *p; p = &(*p)->next) {
+		if (*p == this) {
+			*p = next;
+			break;
+		}
+	}
+}
+
+void MAX31329_Sim::powerOn() {
+	resetRegisters();
+	regs[MAX31329_REG_RTC_RESET] = 0;
+	lastUs = MAX31329_SimClock::now();
+	pointer = 0;
+	pfail = false;
+	fault = MAX31329_SIM_FAULT_NONE;
+	faultCount = faultSkip = 0;
+	shortPending = tearArmed = false;
+	stuckClocks = 0;
+	count = MAX31329_SimCounters();
+	updateInt();
+}
+
+// SWRST and POR: every I2C register except the RAM and SWRST itself
+void MAX31329_Sim::resetRegisters() {
+	uint8_t swrst = regs[MAX31329_REG_RTC_RESET];
+	memset(regs, 0, MAX31329_REG_RAM_START);
+	regs[MAX31329_REG_STATUS] = MAX31329_STATUS_OSF;
+	regs[MAX31329_REG_RTC_RESET] = swrst;
+	regs[MAX31329_REG_CFG1] = MAX31329_CFG1_ENIO | MAX31329_CFG1_I2C_TIMEOUT | MAX31329_CFG1_ENOSC;
+	regs[MAX31329_REG_TIMER_CONFIG] = MAX31329_TMR_TRPT;
+	regs[MAX31329_REG_PWR_MGMT] = MAX31329_PWR_PFVT_MASK;
+	secs = EPOCH_2000;
+	phaseUs = 0;
+	timerPhase = 0;
+	latchTime();
+}
+
+bool MAX31329_Sim::oscillating() const {
+	return (regs[MAX31329_REG_CFG1] & MAX31329_CFG1_ENOSC) &&
+		!(regs[MAX31329_REG_RTC_RESET] & MAX31329_RESET_SWRST);
+}
+
+// Bring the device up to the virtual clock. Alarm flags are sticky, so
+// seconds are stepped one by one only while a match can still change them.
+void MAX31329_Sim::sync() {
+	int64_t now = MAX31329_SimClock::now();
+	int64_t dt = now - lastUs;
+	lastUs = now;
+	if (dt <= 0 || !oscillating()) return;
+	double dev = (double)dt * (1.0 + ppm * 1e-6);
+	advanceTimer(dev);
+	phaseUs += dev;
+	if (phaseUs >= 1e6) {
+		int64_t whole = (int64_t)(phaseUs / 1e6);
+		phaseUs -= (double)whole * 1e6;
+		const uint8_t both = MAX31329_STATUS_A1F | MAX31329_STATUS_A2F;
+		for (; whole > 0 && (regs[MAX31329_REG_STATUS] & both) != both; --whole) tickSecond();
+		secs += whole;
+	}
+	updateInt();
+}
+
+void MAX31329_Sim::advanceTimer(double deviceUs) {
+	static const double HZ[4] = {1024.0, 256.0, 64.0, 16.0};
+	uint8_t cfg = regs[MAX31329_REG_TIMER_CONFIG];
+	uint8_t &value = regs[MAX31329_REG_TIMER_COUNT];
+	if (!(cfg & MAX31329_TMR_TE) || (cfg & MAX31329_TMR_TPAUSE) || value == 0) return;
+	timerPhase += deviceUs * HZ[cfg & MAX31329_TMR_TFS_MASK] / 1e6;
+	uint64_t ticks = (uint64_t)timerPhase;
+	timerPhase -= (double)ticks;
+	if (ticks < value) {
+		value = (uint8_t)(value - ticks);
+		return;
+	}
+	regs[MAX31329_REG_STATUS] |= MAX31329_STATUS_TIF;
+	uint8_t init = regs[MAX31329_REG_TIMER_INIT];
+	// Repeat mode reloads on reaching 0, so the period is TIMER_INIT ticks
+	value = ((cfg & MAX31329_TMR_TRPT) && init) ? (uint8_t)(init - (ticks - value) % init) : 0;
+}
+
+void MAX31329_Sim::tickSecond() {
+	++secs;
+	if (matchAlarm1()) regs[MAX31329_REG_STATUS] |= MAX31329_STATUS_A1F;
+	if (matchAlarm2()) regs[MAX31329_REG_STATUS] |= MAX31329_STATUS_A2F;
+}
+
+// Alarm hours follow the clock's 12/24-hour format
+static int alarmHour(uint8_t reg, bool mode12) {
+	if (!mode12) return fromBcd(reg & 0x3F);
+	int h = fromBcd(reg & 0x1F) % 12;
+	return (reg & MAX31329_HOURS_AM_PM) ? h + 12 : h;
+}
+
+static bool matchDayDate(uint8_t reg, const SimFields &f) {
+	if (reg & MAX31329_ALM_MASK) return true;
+	if (reg & MAX31329_ALM_DY_DT) return (reg & 0x07) == f.day;
+	return fromBcd(reg & 0x3F) == f.date;
+}
+
+bool MAX31329_Sim::matchAlarm1() const {
+	const uint8_t *a = &regs[MAX31329_REG_ALM1_SEC];
+	bool mode12 = (regs[MAX31329_REG_HOURS] & MAX31329_HOURS_F_24_12) != 0;
+	SimFields f;
+	fieldsOf(secs, f);
+	if (!(a[0] & MAX31329_ALM_MASK) && fromBcd(a[0] & 0x7F) != f.sec) return false;
+	if (!(a[1] & MAX31329_ALM_MASK) && fromBcd(a[1] & 0x7F) != f.min) return false;
+	if (!(a[2] & MAX31329_ALM_MASK) && alarmHour(a[2], mode12) != f.hour) return false;
+	if (!matchDayDate(a[3], f)) return false;
+	if (!(a[4] & MAX31329_ALM_MASK) && fromBcd(a[4] & 0x1F) != f.month) return false;
+	if (!(a[4] & MAX31329_ALM1_MON_A1M6) && fromBcd(a[5]) != f.year % 100) return false;
+	return true;
+}
+
+// Alarm2 has no seconds register: it matches at :00
+bool MAX31329_Sim::matchAlarm2() const {
+	const uint8_t *a = &regs[MAX31329_REG_ALM2_MIN];
+	bool mode12 = (regs[MAX31329_REG_HOURS] & MAX31329_HOURS_F_24_12) != 0;
+	SimFields f;
+	fieldsOf(secs, f);
+	if (f.sec != 0) return false;
+	if (!(a[0] & MAX31329_ALM_MASK) && fromBcd(a[0] & 0x7F) != f.min) return false;
+	if (!(a[1] & MAX31329_ALM_MASK) && alarmHour(a[1], mode12) != f.hour) return false;
+	return matchDayDate(a[2], f);
+}
+
+// Time registers from the counter. DAY follows the date (1 = Sunday).
+void MAX31329_Sim::latchTime() {
+	SimFields f;
+	fieldsOf(secs, f);
+	uint8_t *r = &regs[MAX31329_REG_SECONDS];
+	r[0] = toBcd(f.sec);
+	r[1] = toBcd(f.min);
+	if (r[2] & MAX31329_HOURS_F_24_12) {
+		int h = f.hour % 12;
+		r[2] = (uint8_t)(MAX31329_HOURS_F_24_12 | toBcd(h ? h : 12) |
+			(f.hour >= 12 ? MAX31329_HOURS_AM_PM : 0));
+	} else {
+		r[2] = toBcd(f.hour);
+	}
+	r[3] = (uint8_t)f.day;
+	r[4] = toBcd(f.date);
+	r[5] = (uint8_t)(toBcd(f.month) | (f.year >= 2100 ? MAX31329_MONTH_CENTURY : 0));
+	r[6] = toBcd(f.year % 100);
+}
+
+// Counter from the time registers. Writing SECONDS resets the divider chain.
+void MAX31329_Sim::loadTime(bool dividerReset) {
+	const uint8_t *r = &regs[MAX31329_REG_SECONDS];
+	int hour = (r[2] & MAX31329_HOURS_F_24_12) ? alarmHour(r[2] & 0x3F, true) : fromBcd(r[2] & 0x3F);
+	int year = 2000 + fromBcd(r[6]) + ((r[5] & MAX31329_MONTH_CENTURY) ? 100 : 0);
+	int32_t days = daysFromCivil(year, (unsigned)fromBcd(r[5] & 0x1F), (unsigned)fromBcd(r[4] & 0x3F));
+	secs = (int64_t)days * 86400 + hour * 3600 + fromBcd(r[1] & 0x7F) * 60 + fromBcd(r[0] & 0x7F);
+	if (dividerReset) phaseUs = 0;
+}
+
+void MAX31329_Sim::setEpoch(int64_t epoch) {
+	sync();
+	secs = epoch;
+	phaseUs = 0;
+}
+
+int64_t MAX31329_Sim::epoch() {
+	sync();
+	return secs;
+}
+
+int64_t MAX31329_Sim::epochUs() {
+	sync();
+	return secs * 1000000 + (int64_t)phaseUs;
+}
+
+void MAX31329_Sim::setPpm(double value) {
+	sync();
+	ppm = value;
+}
+
+uint8_t MAX31329_Sim::peek(uint8_t reg) {
+	sync();
+	latchTime();
+	return reg < MAX31329_SIM_REGS ? regs[reg] : 0;
+}
+
+void MAX31329_Sim::poke(uint8_t reg, uint8_t value) {
+	if (reg >= MAX31329_SIM_REGS) return;
+	sync();
+	latchTime();
+	regs[reg] = value;
+	if (reg >= MAX31329_REG_SECONDS && reg <= MAX31329_REG_YEAR) loadTime(false);
+	updateInt();
+}
+
+MAX31329_SimFault MAX31329_Sim::takeFault(bool reading) {
+	if (fault == MAX31329_SIM_FAULT_NONE) return fault;
+	if (faultSkip) {
+		--faultSkip;
+		return MAX31329_SIM_FAULT_NONE;
+	}
+	// A short read only hits reads; writes leave it queued
+	if (fault == MAX31329_SIM_FAULT_SHORT_READ && !reading) return MAX31329_SIM_FAULT_NONE;
+	MAX31329_SimFault f = fault;
+	if (--faultCount == 0) fault = MAX31329_SIM_FAULT_NONE;
+	return f;
+}
+
+static uint8_t resultOf(MAX31329_SimFault f) {
+	switch (f) {
+	case MAX31329_SIM_FAULT_ADDR_NACK: return MAX31329_SIM_RESULT_ADDR_NACK;
+	case MAX31329_SIM_FAULT_DATA_NACK: return MAX31329_SIM_RESULT_DATA_NACK;
+	case MAX31329_SIM_FAULT_ARBITRATION: return MAX31329_SIM_RESULT_OTHER;
+	case MAX31329_SIM_FAULT_TIMEOUT: return MAX31329_SIM_RESULT_TIMEOUT;
+	default: return MAX31329_SIM_RESULT_OK;
+	}
+}
+
+uint8_t MAX31329_Sim::select(uint8_t reg) {
+	sync();
+	if (stuckClocks) {
+		++count.faults;
+		return MAX31329_SIM_RESULT_TIMEOUT;
+	}
+	MAX31329_SimFault f = takeFault(true);
+	if (f == MAX31329_SIM_FAULT_SHORT_READ) {
+		shortPending = true;
+	} else if (f != MAX31329_SIM_FAULT_NONE) {
+		++count.faults;
+		return resultOf(f);
+	}
+	pointer = reg;
+	return MAX31329_SIM_RESULT_OK;
+}
+
+size_t MAX31329_Sim::receive(uint8_t *buffer, size_t length) {
+	sync();
+	latchTime();
+	size_t n = length;
+	if (shortPending) {
+		shortPending = false;
+		n = length / 2;
+		++count.faults;
+	} else {
+		++count.reads;
+	}
+	for (size_t i = 0; i < n; ++i) {
+		size_t r = (size_t)pointer + i;
+		uint8_t v = r < MAX31329_SIM_REGS ? regs[r] : 0;
+		if (r == MAX31329_REG_STATUS && (regs[MAX31329_REG_INT_EN] & MAX31329_INT_DOSF)) {
+			v &= (uint8_t)~MAX31329_STATUS_OSF;
+		}
+		buffer[i] = v;
+	}
+	// Clear on read; a persisting power fail or stopped oscillator sets again
+	if (pointer == MAX31329_REG_STATUS && n > 0) {
+		uint8_t keep = MAX31329_STATUS_PSDECT;
+		if (pfail) keep |= MAX31329_STATUS_PFAIL;
+		if (!oscillating()) keep |= MAX31329_STATUS_OSF;
+		regs[MAX31329_REG_STATUS] &= keep;
+	}
+	count.bytesRead += (uint32_t)n;
+	pointer = (uint8_t)(pointer + n);
+	updateInt();
+	return n;
+}
+
+uint8_t MAX31329_Sim::write(uint8_t reg, const uint8_t *buffer, size_t length) {
+	sync();
+	if (stuckClocks) {
+		++count.faults;
+		return MAX31329_SIM_RESULT_TIMEOUT;
+	}
+	MAX31329_SimFault f = takeFault(false);
+	if (f != MAX31329_SIM_FAULT_NONE) {
+		++count.faults;
+		return resultOf(f);
+	}
+	size_t n = length;
+	bool torn = false;
+	if (tearArmed && tearSkip) {
+		--tearSkip;
+	} else if (tearArmed) {
+		tearArmed = false;
+		if (tearBytes < n) {
+			n = tearBytes;
+			torn = true;
+		}
+	}
+	latchTime();
+	uint8_t oldTimer = regs[MAX31329_REG_TIMER_CONFIG];
+	uint8_t oldCfg1 = regs[MAX31329_REG_CFG1];
+	bool timeWritten = false, secondsWritten = false, resetWritten = false;
+	for (size_t i = 0; i < n; ++i) {
+		size_t r = (size_t)reg + i;
+		if (r >= MAX31329_SIM_REGS) break;
+		// STATUS and TIMER_COUNT are read-only, 0x1A..0x21 reserved
+		if (r == MAX31329_REG_STATUS || r == MAX31329_REG_TIMER_COUNT) continue;
+		if (r > MAX31329_REG_TRICKLE && r < MAX31329_REG_RAM_START) continue;
+		regs[r] = buffer[i];
+		if (r >= MAX31329_REG_SECONDS && r <= MAX31329_REG_YEAR) timeWritten = true;
+		if (r == MAX31329_REG_SECONDS) secondsWritten = true;
+		if (r == MAX31329_REG_RTC_RESET) resetWritten = true;
+	}
+	if (timeWritten) loadTime(secondsWritten);
+	uint8_t cfg = regs[MAX31329_REG_TIMER_CONFIG];
+	if ((cfg & MAX31329_TMR_TE) && !(oldTimer & MAX31329_TMR_TE)) {
+		regs[MAX31329_REG_TIMER_COUNT] = regs[MAX31329_REG_TIMER_INIT];
+		timerPhase = 0;
+	} else if (!(cfg & MAX31329_TMR_TE)) {
+		regs[MAX31329_REG_TIMER_COUNT] = 0;
+	}
+	if ((oldCfg1 & MAX31329_CFG1_ENOSC) && !(regs[MAX31329_REG_CFG1] & MAX31329_CFG1_ENOSC)) {
+		regs[MAX31329_REG_STATUS] |= MAX31329_STATUS_OSF;
+	}
+	if (resetWritten && (regs[MAX31329_REG_RTC_RESET] & MAX31329_RESET_SWRST)) resetRegisters();
+	pointer = (uint8_t)(reg + n);
+	count.bytesWritten += (uint32_t)n;
+	updateInt();
+	if (torn) {
+		++count.faults;
+		return MAX31329_SIM_RESULT_DATA_NACK;
+	}
+	++count.writes;
+	return MAX31329_SIM_RESULT_OK;
+}
+
+void MAX31329_Sim::updateInt() {
+	const uint8_t sources = MAX31329_STATUS_A1F | MAX31329_STATUS_A2F | MAX31329_STATUS_TIF |
+		MAX31329_STATUS_DIF | MAX31329_STATUS_PFAIL;
+	bool level = (regs[MAX31329_REG_STATUS] & regs[MAX31329_REG_INT_EN] & sources) != 0;
+	if (level == intLevel) return;
+	intLevel = level;
+	if (intPin >= 0) hostDrivePin((uint8_t)intPin, level ? LOW : HIGH);
+}
+
+bool MAX31329_Sim::intAsserted() {
+	sync();
+	return intLevel;
+}
+
+void MAX31329_Sim::sclPulse() {
+	++count.sclPulses;
+	if (stuckClocks) --stuckClocks;
+}
+
+void MAX31329_Sim::setPowerFail(bool failing) {
+	sync();
+	pfail = failing;
+	if (failing) regs[MAX31329_REG_STATUS] |= MAX31329_STATUS_PFAIL;
+	updateInt();
+}
+
+void MAX31329_Sim::setOnBattery(bool battery) {
+	sync();
+	if (battery) regs[MAX31329_REG_STATUS] |= MAX31329_STATUS_PSDECT;
+	else regs[MAX31329_REG_STATUS] &= (uint8_t)~MAX31329_STATUS_PSDECT;
+}
+
+void MAX31329_Sim::inject(MAX31329_SimFault f, uint32_t n, uint32_t skip) {
+	fault = n ? f : MAX31329_SIM_FAULT_NONE;
+	faultCount = n;
+	faultSkip = skip;
+}
+
+void MAX31329_Sim::tearNextWrite(size_t bytes, uint32_t skipWrites) {
+	tearBytes = bytes;
+	tearSkip = skipWrites;
+	tearArmed = true;
+}
+
+void MAX31329_Sim::holdSda(uint8_t clocks) {
+	stuckClocks = clocks;
+}
+
+int64_t MAX31329_Sim::transferUs(size_t bytes, uint32_t frequency) {
+	if (!frequency) frequency = 100000U;
+	// 9 clocks per byte plus START and STOP
+	uint64_t bits = (uint64_t)bytes * 9 + 2;
+	return (int64_t)((bits * 1000000U + frequency - 1) / frequency);
+}
+
+void MAX31329_Sim::syncAll() {
+	for (MAX31329_Sim *d = devices; d; d = d->next) d->sync();
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_SIM_H
+#define KODE_MAX31329_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "MAX31329_registers.h"
+
+// Register-level model of the MAX31329 for host builds. The device runs on a
+// virtual clock shared with the Arduino stand-in (micros(), delay()) and is
+// reached either through the TwoWire stand-in (attach it to Wire) or through
+// the MAX31329_SimBus policy. Modelled: BCD time with an oscillator error,
+// Alarm1/Alarm2 matching with mask bits, the countdown timer at its four
+// frequencies, clear-on-read STATUS, the INT output, SWRST, 64 bytes of
+// NVRAM, per-transaction counters and deterministic fault injection.
+
+#define MAX31329_SIM_REGS 0x62
+
+// Wire-style transaction results (TwoWire::endTransmission() codes)
+#define MAX31329_SIM_RESULT_OK         0
+#define MAX31329_SIM_RESULT_ADDR_NACK  2
+#define MAX31329_SIM_RESULT_DATA_NACK  3
+#define MAX31329_SIM_RESULT_OTHER      4
+#define MAX31329_SIM_RESULT_TIMEOUT    5
+
+// Host virtual clock. Starts at 1 s and only moves when advanced, by the bus
+// stand-ins (transfer time) or by delay()/delayMicroseconds().
+class MAX31329_SimClock {
+public:
+	static int64_t now();
+	static void advance(int64_t us);
+	static void reset(int64_t us = 1000000);
+};
+
+enum MAX31329_SimFault : uint8_t {
+	MAX31329_SIM_FAULT_NONE = 0,
+	MAX31329_SIM_FAULT_ADDR_NACK,   // nobody acknowledges the address
+	MAX31329_SIM_FAULT_DATA_NACK,   // a data byte is refused, nothing is written
+	MAX31329_SIM_FAULT_ARBITRATION, // another master wins arbitration
+	MAX31329_SIM_FAULT_TIMEOUT,     // SCL held past the bus timeout
+	MAX31329_SIM_FAULT_SHORT_READ   // a read returns half the bytes
+};
+
+struct MAX31329_SimCounters {
+	uint32_t reads = 0;        // completed read transactions
+	uint32_t writes = 0;       // completed write transactions
+	uint32_t bytesRead = 0;
+	uint32_t bytesWritten = 0; // data bytes, register pointer excluded
+	uint32_t faults = 0;       // transactions that failed
+	uint32_t sclPulses = 0;    // recovery clocks seen while the bus was idle
+};
+
+class MAX31329_Sim {
+public:
+	explicit MAX31329_Sim(uint8_t address = MAX31329_I2C_ADDRESS);
+	~MAX31329_Sim();
+
+	uint8_t address() const { return addr; }
+
+	// Power-on reset: register defaults, OSF set, 2000-01-01 00:00:00, NVRAM
+	// kept (it is battery backed). Counters and faults are cleared.
+	void powerOn();
+
+	// Time
+	void setEpoch(int64_t epoch);   // second boundary at the current instant
+	int64_t epoch();                // current device second
+	int64_t epochUs();              // device time including the divider phase
+	void setPpm(double ppm);        // oscillator error, positive runs fast
+
+	// Registers without bus side effects (time registers reflect now)
+	uint8_t peek(uint8_t reg);
+	void poke(uint8_t reg, uint8_t value);
+
+	// Bus side. select() is the write phase of a read, receive() the read
+	// phase (the time registers latch at its START), write() one write
+	// transaction. Results are MAX31329_SIM_RESULT_*.
+	uint8_t select(uint8_t reg);
+	size_t receive(uint8_t *buffer, size_t length);
+	uint8_t write(uint8_t reg, const uint8_t *buffer, size_t length);
+
+	// Pins
+	void setIntPin(int pin) { intPin = pin; } // drives the ISR attached there
+	bool intAsserted();                       // INTA low
+	bool sdaHeld() const { return stuckClocks > 0; }
+	void sclPulse();
+	void setPowerFail(bool failing);          // VCC below the PFVT threshold
+	void setOnBattery(bool battery);          // PSDECT
+
+	// Deterministic fault injection: after `skip` transactions, the next
+	// `count` fail with `fault`.
+	void inject(MAX31329_SimFault fault, uint32_t count = 1, uint32_t skip = 0);
+	// The next write (after `skipWrites` complete ones) stores only its first
+	// `bytes` data bytes, then NACKs
+	void tearNextWrite(size_t bytes, uint32_t skipWrites = 0);
+	// Hold SDA low as if stopped mid-byte; released after `clocks` SCL pulses
+	void holdSda(uint8_t clocks);
+
+	const MAX31329_SimCounters &counters() const { return count; }
+	void resetCounters() { count = MAX31329_SimCounters(); }
+
+	// Bus time of one transaction of `bytes` bytes (address included)
+	static int64_t transferUs(size_t bytes, uint32_t frequency);
+
+	// Bring every device up to the virtual clock (MAX31329_SimClock::advance)
+	static void syncAll();
+
+private:
+	uint8_t addr;
+	uint8_t regs[MAX31329_SIM_REGS];
+	uint8_t pointer;
+	int64_t secs;       // device epoch second
+	double phaseUs;     // device microseconds into the current second
+	double timerPhase;  // fraction of the next timer tick
+	double ppm;
+	int64_t lastUs;     // virtual time of the last sync()
+	bool pfail;
+	bool intLevel;
+	int intPin;
+	MAX31329_SimFault fault;
+	uint32_t faultCount;
+	uint32_t faultSkip;
+	bool shortPending;
+	size_t tearBytes;
+	uint32_t tearSkip;
+	bool tearArmed;
+	uint8_t stuckClocks;
+	MAX31329_SimCounters count;
+	MAX31329_Sim *next;
+
+	void resetRegisters();
+	bool oscillating() const;
+	void sync();
+	void advanceTimer(double deviceUs);
+	void tickSecond();
+	bool matchAlarm1() const;
+	bool matchAlarm2() const;
+	void latchTime();
+	void loadTime(bool dividerReset);
+	MAX31329_SimFault takeFault(bool reading);
+	void updateInt();
+};
+
+#endif // KODE_MAX31329_SIM_H
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_SIMBUS_H
+#define KODE_MAX31329_SIMBUS_H
+
+#include "MAX31329_bus.h"
+#include "MAX31329_sim.h"
+
+// Bus policy that talks to a MAX31329_Sim directly, without the TwoWire
+// stand-in. Build with
+//   -DKODE_MAX31329_BUS=MAX31329_SimBus -include MAX31329_simbus.h
+// and start the driver with rtc.begin(MAX31329_SimBus(sim)).
+struct MAX31329_SimBus {
+	MAX31329_Sim *sim = nullptr;
+	uint32_t frequency = 400000U;
+	uint16_t timeoutMs = MAX31329_BUS_DEFAULT_TIMEOUT_MS;
+	MAX31329_Error err = MAX31329_OK;
+
+	MAX31329_SimBus() {}
+	explicit MAX31329_SimBus(MAX31329_Sim &s) : sim(&s) {}
+
+	bool attached() const { return sim != nullptr; }
+	MAX31329_Error error() const { return err; }
+
+	bool read(uint8_t reg, uint8_t *buffer, size_t length) {
+		if (!done(sim->select(reg), 2)) return false;
+		size_t n = sim->receive(buffer, length);
+		MAX31329_SimClock::advance(MAX31329_Sim::transferUs(1 + length, frequency));
+		err = n == length ? MAX31329_OK : MAX31329_ERR_SHORT_READ;
+		return n == length;
+	}
+
+	bool write(uint8_t reg, const uint8_t *buffer, size_t length) {
+		if (length > MAX31329_BUS_MAX_WRITE) {
+			err = MAX31329_ERR_LENGTH;
+			return false;
+		}
+		MAX31329_SimClock::advance(MAX31329_Sim::transferUs(2 + length, frequency));
+		return done(sim->write(reg, buffer, length), 0);
+	}
+
+	void setTimeout(uint16_t ms) { timeoutMs = ms; }
+
+	// Nine clocks at most, then a STOP (the tenth rising edge)
+	bool recover() {
+		if (!sim) return false;
+		for (uint8_t i = 0; i < 9 && sim->sdaHeld(); ++i) sim->sclPulse();
+		sim->sclPulse();
+		MAX31329_SimClock::advance(MAX31329_BUS_RECOVERY_US);
+		return !sim->sdaHeld();
+	}
+
+private:
+	// Results share the endTransmission() codes; bytes > 0 bills the bus time
+	bool done(uint8_t result, size_t bytes) {
+		if (bytes) MAX31329_SimClock::advance(MAX31329_Sim::transferUs(bytes, frequency));
+		if (result == MAX31329_SIM_RESULT_TIMEOUT) MAX31329_SimClock::advance((int64_t)timeoutMs * 1000);
+		err = MAX31329_WireBus::fromWire(result);
+		return err == MAX31329_OK;
+	}
+};
+
+#endif // KODE_MAX31329_SIMBUS_H
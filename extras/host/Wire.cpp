@@ -0,0 +1,156 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <Wire.h>
+
+#include "MAX31329_sim.h"
+
+TwoWire Wire(0);
+TwoWire Wire1(1);
+
+static TwoWire *const buses[] = {&Wire, &Wire1};
+
+TwoWire::TwoWire(uint8_t busNum) {
+	(void)busNum;
+}
+
+bool TwoWire::begin(int sdaPin, int sclPin, uint32_t frequency) {
+	if (sdaPin >= 0 && sclPin >= 0) {
+		sda = sdaPin;
+		scl = sclPin;
+	}
+	if (frequency) clockHz = frequency;
+	started = true;
+	sclLevel = HIGH;
+	++begins;
+	return true;
+}
+
+bool TwoWire::end() {
+	started = false;
+	return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+	if (frequency) clockHz = frequency;
+	return true;
+}
+
+void TwoWire::beginTransmission(int address) {
+	txAddress = (uint8_t)address;
+	txLength = 0;
+	txOverflow = false;
+}
+
+size_t TwoWire::write(uint8_t data) {
+	if (txLength >= HOST_WIRE_BUFFER) {
+		txOverflow = true;
+		return 0;
+	}
+	tx[txLength++] = data;
+	return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length) {
+	size_t n = 0;
+	while (n < length && write(data[n])) ++n;
+	return n;
+}
+
+// The first byte is the register pointer. A pointer alone with no STOP is
+// the write phase of a read.
+uint8_t TwoWire::endTransmission(bool sendStop) {
+	if (!started) return 4;
+	if (txOverflow) return 1;
+	MAX31329_Sim *dev = device(txAddress);
+	if (!dev) {
+		MAX31329_SimClock::advance(MAX31329_Sim::transferUs(1, clockHz));
+		return 2;
+	}
+	if (txLength == 0) {
+		MAX31329_SimClock::advance(MAX31329_Sim::transferUs(1, clockHz));
+		return 0;
+	}
+	MAX31329_SimClock::advance(MAX31329_Sim::transferUs(1 + txLength, clockHz));
+	uint8_t result = (txLength == 1 && !sendStop) ? dev->select(tx[0]) :
+		dev->write(tx[0], tx + 1, txLength - 1);
+	if (result == MAX31329_SIM_RESULT_TIMEOUT) MAX31329_SimClock::advance((int64_t)timeoutMs * 1000);
+	return result;
+}
+
+size_t TwoWire::requestFrom(uint16_t address, size_t size, bool sendStop) {
+	(void)sendStop;
+	rxLength = rxPos = 0;
+	if (!started) return 0;
+	if (size > HOST_WIRE_BUFFER) size = HOST_WIRE_BUFFER;
+	MAX31329_Sim *dev = device((uint8_t)address);
+	if (!dev) {
+		MAX31329_SimClock::advance(MAX31329_Sim::transferUs(1, clockHz));
+		return 0;
+	}
+	// The time registers latch at START, the bus time follows
+	rxLength = dev->receive(rx, size);
+	MAX31329_SimClock::advance(MAX31329_Sim::transferUs(1 + size, clockHz));
+	return rxLength;
+}
+
+uint8_t TwoWire::requestFrom(int address, int size, int sendStop) {
+	return (uint8_t)requestFrom((uint16_t)address, (size_t)(size < 0 ? 0 : size), sendStop != 0);
+}
+
+void TwoWire::attach(MAX31329_Sim &dev) {
+	for (MAX31329_Sim *&slot : devices) {
+		if (!slot || slot == &dev) {
+			slot = &dev;
+			return;
+		}
+	}
+}
+
+void TwoWire::detach(MAX31329_Sim &dev) {
+	for (MAX31329_Sim *&slot : devices) {
+		if (slot == &dev) slot = nullptr;
+	}
+}
+
+MAX31329_Sim *TwoWire::device(uint8_t address) const {
+	for (MAX31329_Sim *d : devices) {
+		if (d && d->address() == address) return d;
+	}
+	return nullptr;
+}
+
+int TwoWire::lineLevel(uint8_t pin) {
+	for (TwoWire *bus : buses) {
+		if (bus->sda != pin) continue;
+		for (MAX31329_Sim *d : bus->devices) {
+			if (d && d->sdaHeld()) return LOW;
+		}
+	}
+	return -1;
+}
+
+void TwoWire::lineWritten(uint8_t pin, int level) {
+	for (TwoWire *bus : buses) {
+		if (bus->scl != pin || bus->started) continue;
+		bool rising = level == HIGH && bus->sclLevel == LOW;
+		bus->sclLevel = level;
+		if (!rising) continue;
+		for (MAX31329_Sim *d : bus->devices) {
+			if (d) d->sclPulse();
+		}
+	}
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_HOST_WIRE_H
+#define KODE_MAX31329_HOST_WIRE_H
+
+// TwoWire stand-in for host builds. Transactions go to the MAX31329_Sim
+// devices attached to the bus and advance the virtual clock by their bus
+// time at the configured clock. Return codes follow the ESP32 core:
+// endTransmission() 0 ok, 1 too long, 2 address NACK, 3 data NACK,
+// 4 other, 5 timeout. While the bus is stopped (end()), clocks written to
+// its SCL pin reach the devices, so a bus recovery can be observed.
+
+#include <Arduino.h>
+
+class MAX31329_Sim;
+
+#define HOST_WIRE_BUFFER   128
+#define HOST_WIRE_DEVICES  4
+
+class TwoWire {
+public:
+	explicit TwoWire(uint8_t busNum);
+
+	bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+	bool end();
+	bool setClock(uint32_t frequency);
+	uint32_t getClock() const { return clockHz; }
+	void setTimeOut(uint16_t timeOutMillis) { timeoutMs = timeOutMillis; }
+	uint16_t getTimeOut() const { return timeoutMs; }
+
+	void beginTransmission(int address);
+	size_t write(uint8_t data);
+	size_t write(const uint8_t *data, size_t length);
+	uint8_t endTransmission(bool sendStop = true);
+	size_t requestFrom(uint16_t address, size_t size, bool sendStop = true);
+	uint8_t requestFrom(int address, int size, int sendStop);
+	int available() const { return (int)(rxLength - rxPos); }
+	int read() { return rxPos < rxLength ? rx[rxPos++] : -1; }
+	int peek() const { return rxPos < rxLength ? rx[rxPos] : -1; }
+
+	// Host side
+	void attach(MAX31329_Sim &device);
+	void detach(MAX31329_Sim &device);
+	bool running() const { return started; }
+	int sdaPin() const { return sda; }
+	int sclPin() const { return scl; }
+	uint32_t beginCount() const { return begins; } // begin() calls, recoveries included
+
+	// Called by the Arduino stand-in for the bus lines of stopped buses
+	static int lineLevel(uint8_t pin);             // -1 when no device drives it
+	static void lineWritten(uint8_t pin, int level);
+
+private:
+	bool started = false;
+	int sda = SDA;
+	int scl = SCL;
+	int sclLevel = HIGH;
+	uint32_t clockHz = 100000U;
+	uint16_t timeoutMs = 50;
+	uint32_t begins = 0;
+	MAX31329_Sim *devices[HOST_WIRE_DEVICES] = {};
+	uint8_t txAddress = 0;
+	uint8_t tx[HOST_WIRE_BUFFER];
+	size_t txLength = 0;
+	bool txOverflow = false;
+	uint8_t rx[HOST_WIRE_BUFFER];
+	size_t rxLength = 0;
+	size_t rxPos = 0;
+
+	MAX31329_Sim *device(uint8_t address) const;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif // KODE_MAX31329_HOST_WIRE_H
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Runs an example sketch against a simulated MAX31329 on Wire:
+//
+//   <sketch> [seconds] [int-pin] [output-file]
+//
+// setup() runs once, then loop() until `seconds` of virtual time have
+// passed, with 1 ms between iterations. The device INT output drives
+// `int-pin`; everything printed to Serial is also written to `output-file`.
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "MAX31329_sim.h"
+
+void setup();
+void loop();
+
+int main(int argc, char **argv) {
+	double seconds = argc > 1 ? atof(argv[1]) : 5.0;
+	int intPin = argc > 2 ? atoi(argv[2]) : -1;
+	FILE *out = nullptr;
+	if (argc > 3 && !(out = fopen(argv[3], "w"))) {
+		perror(argv[3]);
+		return 2;
+	}
+
+	MAX31329_Sim sim;
+	sim.setEpoch(1735689600); // 2025-01-01 00:00:00
+	sim.setIntPin(intPin);
+	Wire.attach(sim);
+	Serial.tee(out);
+
+	setup();
+	int64_t end = MAX31329_SimClock::now() + (int64_t)(seconds * 1e6);
+	while (MAX31329_SimClock::now() < end) {
+		loop();
+		MAX31329_SimClock::advance(1000);
+	}
+
+	Serial.tee(nullptr);
+	if (out) fclose(out);
+	fflush(stdout);
+	return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_CHECK_H
+#define KODE_MAX31329_CHECK_H
+
+// Checks for the host tests: a failed CHECK prints where and carries on,
+// checkReport() turns the count into the exit status for ctest.
+
+#include <stdio.h>
+
+static int checkFailures = 0;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		++checkFailures; \
+		printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+	} \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+	long long a_ = (long long)(a), b_ = (long long)(b); \
+	if (a_ != b_) { \
+		++checkFailures; \
+		printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, a_, b_); \
+	} \
+} while (0)
+
+#define CHECK_NEAR(a, b, tol) do { \
+	double a_ = (double)(a), b_ = (double)(b); \
+	if (!(a_ - b_ <= (tol) && b_ - a_ <= (tol))) { \
+		++checkFailures; \
+		printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g (tol %g)\n", __FILE__, __LINE__, \
+			#a, #b, a_, b_, (double)(tol)); \
+	} \
+} while (0)
+
+static inline int checkReport(const char *name) {
+	printf("%s: %s (%d failed)\n", name, checkFailures ? "FAIL" : "PASS", checkFailures);
+	return checkFailures ? 1 : 0;
+}
+
+#endif // KODE_MAX31329_CHECK_H
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Bus faults through the Wire backend: NACKs, arbitration loss and a device
+// holding SDA, injected on the simulated device. Checks the error codes, the
+// retry and recovery counts, the SCL clocks and Wire restarts of a recovery,
+// and the retry deadline.
+
+#include <kode_MAX31329.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static void reset() {
+	rtc.setRetry(0);
+	rtc.setBusRecovery(false);
+	rtc.setBusTimeout(0);
+	rtc.busHealthReset();
+	sim.resetCounters();
+}
+
+static void testNack() {
+	reset();
+	uint32_t begins = Wire.beginCount();
+	sim.inject(MAX31329_SIM_FAULT_ADDR_NACK);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_ADDR_NACK);
+	CHECK_EQ(rtc.busHealth().failures, 1);
+
+	// A refused data byte writes nothing
+	uint8_t before = sim.peek(MAX31329_REG_TRICKLE);
+	sim.inject(MAX31329_SIM_FAULT_DATA_NACK);
+	CHECK(!rtc.trickleEnable(0x5));
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_DATA_NACK);
+	CHECK_EQ(sim.peek(MAX31329_REG_TRICKLE), before);
+
+	// NACKs are retried but never trigger a recovery
+	rtc.setRetry(2, 100);
+	rtc.setBusRecovery(true);
+	sim.inject(MAX31329_SIM_FAULT_ADDR_NACK, 2);
+	CHECK(rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_OK);
+	sim.inject(MAX31329_SIM_FAULT_DATA_NACK, 3);
+	CHECK(!rtc.trickleEnable(0x5));
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_DATA_NACK);
+	MAX31329_BusHealth h = rtc.busHealth();
+	CHECK_EQ(h.retries, 4);
+	CHECK_EQ(h.recoveries, 0);
+	CHECK_EQ(h.failures, 3);
+	CHECK_EQ(sim.counters().faults, 7);
+	CHECK_EQ(sim.counters().sclPulses, 0);
+	CHECK_EQ(Wire.beginCount(), begins);
+}
+
+static void testArbitration() {
+	reset();
+	uint32_t begins = Wire.beginCount();
+	sim.inject(MAX31329_SIM_FAULT_ARBITRATION);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_BUS);
+	CHECK_EQ(Wire.beginCount(), begins);
+
+	// With recovery the retry follows a STOP on a free bus: no clocking
+	// needed, one SCL rise for the STOP and a Wire restart
+	rtc.setRetry(1, 100);
+	rtc.setBusRecovery(true);
+	sim.inject(MAX31329_SIM_FAULT_ARBITRATION);
+	CHECK(rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_OK);
+	CHECK_EQ(rtc.busHealth().retries, 1);
+	CHECK_EQ(rtc.busHealth().recoveries, 1);
+	CHECK_EQ(sim.counters().sclPulses, 1);
+	CHECK_EQ(Wire.beginCount(), begins + 1);
+	CHECK(Wire.running());
+}
+
+static void testStuckSda() {
+	// Held SDA times every transfer out until the bus is clocked free
+	reset();
+	uint32_t begins = Wire.beginCount();
+	sim.holdSda(5);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_TIMEOUT);
+	CHECK(!rtc.readTime());
+	CHECK(sim.sdaHeld());
+	CHECK_EQ(sim.counters().sclPulses, 0);
+
+	// Five clocks release it, plus the STOP
+	CHECK(rtc.recoverBus());
+	CHECK(!sim.sdaHeld());
+	CHECK_EQ(sim.counters().sclPulses, 6);
+	CHECK_EQ(Wire.beginCount(), begins + 1);
+	CHECK_EQ(rtc.busHealth().recoveries, 1);
+	CHECK(rtc.readTime());
+
+	// More than nine clocks' worth: the recovery gives up after nine, and
+	// the next one needs the remaining two (the STOP's clock counts too)
+	sim.resetCounters();
+	sim.holdSda(12);
+	CHECK(!rtc.recoverBus());
+	CHECK(sim.sdaHeld());
+	CHECK_EQ(sim.counters().sclPulses, 10);
+	CHECK(rtc.recoverBus());
+	CHECK_EQ(sim.counters().sclPulses, 13);
+
+	// Automatic: the failed read recovers and the retry succeeds
+	reset();
+	rtc.setRetry(1, 100);
+	rtc.setBusRecovery(true);
+	sim.holdSda(7);
+	CHECK(rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_OK);
+	CHECK(!sim.sdaHeld());
+	CHECK_EQ(sim.counters().sclPulses, 8);
+	CHECK_EQ(rtc.busHealth().retries, 1);
+	CHECK_EQ(rtc.busHealth().recoveries, 1);
+}
+
+static void testDeadline() {
+	// With the default 50 ms bus timeout no retry fits in 3 ms
+	reset();
+	rtc.setRetry(5, 1000, 3000);
+	sim.inject(MAX31329_SIM_FAULT_ADDR_NACK, 6);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_DEADLINE);
+	CHECK_EQ(rtc.busHealth().retries, 0);
+	CHECK_EQ(rtc.worstCaseUs(), 50000);
+
+	// With 1 ms: the first retry (1 ms backoff) fits, the second (2 ms) does not
+	reset();
+	rtc.setRetry(5, 1000, 3000);
+	rtc.setBusTimeout(1);
+	sim.inject(MAX31329_SIM_FAULT_ADDR_NACK, 6);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_DEADLINE);
+	CHECK_EQ(rtc.busHealth().retries, 1);
+	CHECK(rtc.busHealth().worstUs <= rtc.worstCaseUs());
+	CHECK(rtc.busHealth().worstUs <= 3000);
+	reset();
+	sim.inject(MAX31329_SIM_FAULT_NONE, 0);
+	CHECK(rtc.readTime());
+}
+
+static void testNotAttached() {
+	MAX31329 idle;
+	uint8_t v = 0;
+	CHECK(!idle.writeBytes(MAX31329_REG_TRICKLE, &v, 1));
+	CHECK_EQ(idle.lastError(), MAX31329_ERR_NOT_ATTACHED);
+	CHECK(!idle.readBytes(MAX31329_REG_TRICKLE, &v, 1));
+	CHECK_EQ(idle.lastError(), MAX31329_ERR_NOT_ATTACHED);
+	CHECK(!idle.recoverBus());
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testNack();
+	testArbitration();
+	testStuckSda();
+	testDeadline();
+	testNotAttached();
+	return checkReport("test_bus");
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329::commit() transfer plans, counted on the simulated device: the
+// run plan (one write per run of staged registers) against the span plan
+// (one burst from the first to the last staged register, gaps refilled).
+
+#include <kode_MAX31329.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+struct Cost {
+	size_t transfers;
+	uint32_t reads, writes, bytesWritten;
+};
+
+static Cost commitCounted(const MAX31329_Transaction &tx) {
+	sim.resetCounters();
+	Cost c = {0, 0, 0, 0};
+	CHECK(rtc.commit(tx, &c.transfers));
+	c.reads = sim.counters().reads;
+	c.writes = sim.counters().writes;
+	c.bytesWritten = sim.counters().bytesWritten;
+	CHECK_EQ(c.transfers, c.reads + c.writes);
+	return c;
+}
+
+static void reset() {
+	sim.powerOn();
+	rtc.shadowInvalidate();
+}
+
+int main() {
+	Wire.attach(sim);
+	CHECK(rtc.begin());
+
+	// Empty: nothing on the bus
+	MAX31329_Transaction tx;
+	Cost c = commitCounted(tx);
+	CHECK_EQ(c.transfers, 0);
+
+	// Two partial registers with a gap, nothing cached. Runs would read
+	// INT_EN..CFG1 and write twice (3); the span reads the same and writes
+	// once (2), so the span wins and RTC_RESET is written back unchanged.
+	reset();
+	tx.clear();
+	tx.enableInterrupts(MAX31329_INT_A1IE);
+	tx.stopRTC();
+	c = commitCounted(tx);
+	CHECK_EQ(c.reads, 1);
+	CHECK_EQ(c.writes, 1);
+	CHECK_EQ(c.bytesWritten, 3);
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), MAX31329_INT_A1IE);
+	CHECK_EQ(sim.peek(MAX31329_REG_RTC_RESET), 0);
+	CHECK_EQ(sim.peek(MAX31329_REG_CFG1), 0x0A);
+
+	// Whole registers with a gap: runs write twice with no read, the span
+	// would need a read for the gap. A tie goes to runs, the gap is untouched.
+	reset();
+	tx.clear();
+	tx.setRegister(MAX31329_REG_INT_EN, MAX31329_INT_TIE);
+	tx.setRegister(MAX31329_REG_CFG1, 0x0B);
+	c = commitCounted(tx);
+	CHECK_EQ(c.reads, 0);
+	CHECK_EQ(c.writes, 2);
+	CHECK_EQ(c.bytesWritten, 2);
+
+	// Adjacent whole registers form one run: one write
+	reset();
+	tx.clear();
+	tx.setRegister(MAX31329_REG_CFG1, 0x0B);
+	tx.setRegister(MAX31329_REG_CFG2, 0x00);
+	tx.setRegister(MAX31329_REG_TIMER_CONFIG, MAX31329_TMR_TRPT);
+	c = commitCounted(tx);
+	CHECK_EQ(c.reads, 0);
+	CHECK_EQ(c.writes, 1);
+	CHECK_EQ(c.bytesWritten, 3);
+
+	// With the shadow cache the base values are known. CFG1 and TIMER_CONFIG
+	// around a cached CFG2: runs write twice, the span once with no read.
+	reset();
+	rtc.setShadowCache(true);
+	CHECK(rtc.shadowResync());
+	tx.clear();
+	tx.stopRTC();
+	tx.timerPause();
+	c = commitCounted(tx);
+	CHECK_EQ(c.reads, 0);
+	CHECK_EQ(c.writes, 1);
+	CHECK_EQ(c.bytesWritten, 3);
+	CHECK_EQ(sim.peek(MAX31329_REG_CFG1), 0x0A);
+	CHECK_EQ(sim.peek(MAX31329_REG_CFG2), 0x00);
+
+	// RTC_RESET is never cached, so across it the span needs a read again:
+	// two run writes tie with read + burst, and runs win
+	tx.clear();
+	tx.enableInterrupts(MAX31329_INT_A1IE);
+	tx.startRTC();
+	c = commitCounted(tx);
+	CHECK_EQ(c.reads, 0);
+	CHECK_EQ(c.writes, 2);
+	CHECK_EQ(c.bytesWritten, 2);
+	CHECK_EQ(sim.peek(MAX31329_REG_CFG1), 0x0B);
+
+	// A partial run next to a fully staged register, cached: one run
+	tx.clear();
+	tx.enableInterrupts(MAX31329_INT_A2IE);
+	tx.setRegister(MAX31329_REG_RTC_RESET, 0);
+	c = commitCounted(tx);
+	CHECK_EQ(c.reads, 0);
+	CHECK_EQ(c.writes, 1);
+	CHECK_EQ(c.bytesWritten, 2);
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), MAX31329_INT_A1IE | MAX31329_INT_A2IE);
+
+	// The timer touches both blocks. Configure + start must reload
+	// TIMER_INIT, so TE goes out clear with the first block and is set by a
+	// third write; no reads when cached.
+	tx.clear();
+	tx.timerConfigure(100, true, 2);
+	tx.timerStart();
+	c = commitCounted(tx);
+	CHECK_EQ(c.reads, 0);
+	CHECK_EQ(c.writes, 3);
+	CHECK_EQ(sim.peek(MAX31329_REG_TIMER_INIT), 100);
+	CHECK_EQ(sim.peek(MAX31329_REG_TIMER_COUNT), 100);
+	CHECK_EQ(sim.peek(MAX31329_REG_TIMER_CONFIG) & (MAX31329_TMR_TE | MAX31329_TMR_TPAUSE), MAX31329_TMR_TE);
+
+	// The same on a running timer restarts it from the new value
+	MAX31329_SimClock::advance(500000);
+	CHECK(sim.peek(MAX31329_REG_TIMER_COUNT) < 100);
+	tx.clear();
+	tx.timerConfigure(50, false, 2);
+	tx.timerStart();
+	c = commitCounted(tx);
+	CHECK_EQ(c.writes, 3);
+	CHECK_EQ(sim.peek(MAX31329_REG_TIMER_COUNT), 50);
+
+	// Starting without a new configuration is a single write
+	tx.clear();
+	tx.timerStart();
+	c = commitCounted(tx);
+	CHECK_EQ(c.writes, 1);
+
+	// Uncached, configure + start reads TIMER_CONFIG first
+	rtc.setShadowCache(false);
+	reset();
+	tx.clear();
+	tx.timerConfigure(100, true, 2);
+	tx.timerStart();
+	c = commitCounted(tx);
+	CHECK_EQ(c.reads, 1);
+	CHECK_EQ(c.writes, 3);
+	CHECK_EQ(sim.peek(MAX31329_REG_TIMER_COUNT), 100);
+
+	// A staged SWRST resets the chip's configuration: the shadow must not
+	// keep the pre-reset values, and the fast-time anchor is dropped
+	reset();
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	rtc.setShadowCache(true);
+	CHECK(rtc.enableInterrupts(MAX31329_INT_A1IE));
+	CHECK(rtc.stopRTC());
+	CHECK(rtc.startRTC());
+	CHECK(rtc.enableFastTime());
+	int64_t ms = 0;
+	CHECK(rtc.readEpochMs(ms));
+	tx.clear();
+	tx.enableInterrupts(MAX31329_INT_A2IE);
+	tx.assertReset();
+	c = commitCounted(tx);
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), 0);
+	tx.clear();
+	tx.releaseReset();
+	commitCounted(tx);
+	sim.resetCounters();
+	CHECK(rtc.enableInterrupts(MAX31329_INT_TIE));
+	CHECK_EQ(sim.counters().reads, 1); // INT_EN is re-read, not taken from the shadow
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), MAX31329_INT_TIE);
+	sim.resetCounters();
+	CHECK(rtc.readEpochMs(ms));
+	CHECK(sim.counters().reads >= 1); // re-anchored on the chip
+	rtc.setShadowCache(false);
+
+	return checkReport("test_commit");
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_Cron over every minute of four years (2024-2027, one leap day):
+// matches() and the next() chain against hand-written predicates, and the
+// compiled alarm registers, matched by the simulated device, against both.
+// An exact plan must fire on matches only, any plan on every match.
+
+#include <MAX31329_cron.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static const int64_t FROM = 1704067200; // 2024-01-01 00:00:00
+static const int64_t TO = 1830297600;   // 2028-01-01 00:00:00
+
+struct Case {
+	const char *expr;
+	bool exact;
+	uint8_t alarm;
+	bool (*match)(const MAX31329_Time &t);
+};
+
+static bool weekday(const MAX31329_Time &t) { return t.dayOfWeek >= 1 && t.dayOfWeek <= 5; }
+
+static const Case CASES[] = {
+	{"* * * * *", true, 2, [](const MAX31329_Time &) { return true; }},
+	{"@hourly", true, 2, [](const MAX31329_Time &t) { return t.minute == 0; }},
+	{"30 7 * * *", true, 2, [](const MAX31329_Time &t) { return t.hour == 7 && t.minute == 30; }},
+	{"0 9 * * 1", true, 2, [](const MAX31329_Time &t) {
+		return t.dayOfWeek == 1 && t.hour == 9 && t.minute == 0; }},
+	{"0 22 * * 7", true, 2, [](const MAX31329_Time &t) {
+		return t.dayOfWeek == 0 && t.hour == 22 && t.minute == 0; }},
+	{"0 0 31 * *", true, 2, [](const MAX31329_Time &t) {
+		return t.day == 31 && t.hour == 0 && t.minute == 0; }},
+	{"0 0 24 12 *", true, 1, [](const MAX31329_Time &t) {
+		return t.month == 12 && t.day == 24 && t.hour == 0 && t.minute == 0; }},
+	{"45 23 29 FEB *", true, 1, [](const MAX31329_Time &t) {
+		return t.month == 2 && t.day == 29 && t.hour == 23 && t.minute == 45; }},
+	{"15 * * * 1-5", false, 2, [](const MAX31329_Time &t) { return weekday(t) && t.minute == 15; }},
+	{"*/15 8-18 * * MON-FRI", false, 2, [](const MAX31329_Time &t) {
+		return weekday(t) && t.hour >= 8 && t.hour <= 18 && t.minute % 15 == 0; }},
+	{"0 12 1,15 * 5", false, 2, [](const MAX31329_Time &t) {
+		return (t.day == 1 || t.day == 15 || t.dayOfWeek == 5) && t.hour == 12 && t.minute == 0; }},
+	{"5 4 * JAN-MAR SUN", false, 2, [](const MAX31329_Time &t) {
+		return t.month <= 3 && t.dayOfWeek == 0 && t.hour == 4 && t.minute == 5; }},
+	{"0 0 */2 * *", false, 2, [](const MAX31329_Time &t) {
+		return t.day % 2 == 1 && t.hour == 0 && t.minute == 0; }},
+	{"30 1 */3 * *", false, 2, [](const MAX31329_Time &t) {
+		return t.day % 3 == 1 && t.hour == 1 && t.minute == 30; }},
+	{"0 6 * * */2", false, 2, [](const MAX31329_Time &t) {
+		return t.dayOfWeek % 2 == 0 && t.hour == 6 && t.minute == 0; }},
+	{"0 6 * * */3", false, 2, [](const MAX31329_Time &t) {
+		return t.dayOfWeek % 3 == 0 && t.hour == 6 && t.minute == 0; }},
+	// A starred day field ANDs with the other, even when stepped
+	{"0 0 */2 * MON", false, 2, [](const MAX31329_Time &t) {
+		return t.day % 2 == 1 && t.dayOfWeek == 1 && t.hour == 0 && t.minute == 0; }},
+	{"0 0 1 * 0-6", true, 2, [](const MAX31329_Time &t) { return t.hour == 0 && t.minute == 0; }},
+	{"0 6 1 */3 *", false, 2, [](const MAX31329_Time &t) {
+		return t.month % 3 == 1 && t.day == 1 && t.hour == 6 && t.minute == 0; }},
+};
+
+static void scan(const Case &c) {
+	MAX31329_Cron cron;
+	CHECK(cron.parse(c.expr));
+	CHECK_EQ(cron.exact(), c.exact);
+	CHECK_EQ(cron.alarmUsed(), c.alarm);
+	// The superset mask, as arm(rtc, false) programs it
+	if (c.alarm == 1) {
+		CHECK(rtc.setAlarm1(cron.alarm1()));
+	} else {
+		CHECK(rtc.setAlarm2(cron.alarm2()));
+	}
+	const uint8_t flag = c.alarm == 1 ? MAX31329_STATUS_A1F : MAX31329_STATUS_A2F;
+
+	uint32_t matched = 0, fired = 0, wrong = 0, missed = 0, extra = 0, chain = 0;
+	int64_t expect = 0;
+	CHECK(cron.next(FROM - 1, expect));
+	for (int64_t e = FROM; e < TO; e += 60) {
+		MAX31329_Time t;
+		MAX31329::epochToTime(e, t);
+		bool ref = c.match(t);
+
+		// The device ticks into the minute with the alarm registers compiled
+		sim.setEpoch(e - 1);
+		sim.poke(MAX31329_REG_STATUS, 0);
+		MAX31329_SimClock::advance(1000000);
+		bool hw = (sim.peek(MAX31329_REG_STATUS) & flag) != 0;
+
+		if (cron.matches(e) != ref) wrong++;
+		if (ref) matched++;
+		if (hw) fired++;
+		if (ref && !hw) missed++;
+		if (hw && !ref && c.exact) extra++;
+		if (ref) {
+			if (e != expect) chain++;
+			if (!cron.next(e, expect)) expect = TO;
+		} else if (e >= expect) {
+			chain++;
+		}
+	}
+	if (wrong || missed || extra || chain) {
+		printf("%s: %u wrong, %u missed, %u extra, %u out of chain\n", c.expr, wrong, missed, extra, chain);
+	}
+	CHECK_EQ(wrong, 0);
+	CHECK_EQ(missed, 0);
+	CHECK_EQ(extra, 0);
+	CHECK_EQ(chain, 0);
+	CHECK(matched > 0);
+	CHECK(fired >= matched);
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i) scan(CASES[i]);
+
+	// Nothing to wake for
+	MAX31329_Cron never;
+	CHECK(never.parse("0 0 30 2 *"));
+	int64_t at = 0;
+	CHECK(!never.next(FROM, at));
+	CHECK(!never.parse("60 * * * *"));
+	CHECK(!never.parse("* * * *"));
+	return checkReport("test_cron");
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_DriftEstimator against a simulated crystal error: hourly
+// observations of a reference derived from the virtual clock must recover
+// the injected ppm, and the trimmed time must then hold without a reference
+// while the raw time drifts away.
+
+#include <MAX31329_drift.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static const int64_t START_EPOCH = 1735689600;
+static int64_t startUs;
+
+// The virtual clock is true time
+static int64_t trueEpochUs() {
+	return START_EPOCH * 1000000 + (MAX31329_SimClock::now() - startUs);
+}
+
+// A reference good to 1 ms (NTP-like), exact on the virtual clock
+static bool reference(int64_t &refEpochUs, int64_t &capturedAtUs, uint32_t &errorUs, void *) {
+	capturedAtUs = MAX31329_SimClock::now();
+	refEpochUs = trueEpochUs();
+	errorUs = 1000;
+	return true;
+}
+
+// Trimmed (or raw) RTC minus true time, milliseconds. A single read after
+// a long gap only places the second within a 1 s window: pin the edge first.
+static int64_t errorMs() {
+	int64_t ms = 0;
+	CHECK(rtc.syncToEdge());
+	CHECK(rtc.readEpochMs(ms));
+	return ms - trueEpochUs() / 1000;
+}
+
+static void run(double ppm) {
+	sim.setPpm(ppm);
+	CHECK(rtc.writeEpoch(START_EPOCH));
+	startUs = MAX31329_SimClock::now() - (sim.epochUs() - START_EPOCH * 1000000);
+
+	MAX31329_DriftEstimator drift(rtc);
+	drift.setReference(reference);
+	for (int hour = 0; hour < 48; ++hour) {
+		CHECK(drift.observe());
+		MAX31329_SimClock::advance(3600000000LL);
+	}
+	CHECK(drift.observe());
+	CHECK_EQ(drift.observations(), 49);
+	CHECK_NEAR(drift.ppm(), ppm, 0.1);
+	CHECK(drift.ppmSigma() < 0.1);
+
+	// Three days on the trim alone
+	MAX31329_SimClock::advance(3 * 86400000000LL);
+	int64_t trimmed = errorMs();
+	CHECK(trimmed > -20 && trimmed < 20);
+
+	// The raw time has run off by ppm over all five days
+	rtc.clearTrim();
+	int64_t raw = errorMs();
+	CHECK_NEAR(raw, ppm * 5 * 86.4, 100);
+
+	// Writing the time clears the trim; the next observation keeps the rate
+	CHECK(rtc.writeEpoch(trueEpochUs() / 1000000));
+	CHECK(!rtc.trimEnabled());
+	CHECK(drift.observe());
+	CHECK(rtc.trimEnabled());
+	CHECK_NEAR(drift.ppm(), ppm, 0.1);
+	MAX31329_SimClock::advance(86400000000LL);
+	trimmed = errorMs();
+	CHECK(trimmed > -10 && trimmed < 10);
+	rtc.clearTrim();
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	CHECK(rtc.enableFastTime());
+	run(23);
+	run(-41.5);
+	return checkReport("test_drift");
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The direct epoch conversions against the C library over the whole RTC
+// range, 2000-2199: epochToTime()/timeToEpoch() against gmtime_r()/timegm(),
+// and readEpoch()/writeEpoch()/readTime() through the simulated registers.
+
+#include <kode_MAX31329.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static const int64_t FIRST = 946684800;   // 2000-01-01 00:00:00
+static const int64_t END = 7258118400LL;  // 2200-01-01 00:00:00
+
+static void checkSameTm(const struct tm &a, const struct tm &b) {
+	CHECK(a.tm_year == b.tm_year && a.tm_mon == b.tm_mon && a.tm_mday == b.tm_mday);
+	CHECK(a.tm_hour == b.tm_hour && a.tm_min == b.tm_min && a.tm_sec == b.tm_sec);
+	CHECK_EQ(a.tm_wday, b.tm_wday);
+	CHECK_EQ(a.tm_yday, b.tm_yday);
+}
+
+// Every day of the range at a different second of the day
+static void testConversions() {
+	for (int64_t day = 0; FIRST + day * 86400 < END; ++day) {
+		int64_t e = FIRST + day * 86400 + (day * 7919) % 86400;
+		time_t te = (time_t)e;
+		struct tm ref;
+		gmtime_r(&te, &ref);
+
+		MAX31329_Time t;
+		MAX31329::epochToTime(e, t);
+		struct tm tm;
+		t.toTm(tm);
+		checkSameTm(tm, ref);
+		CHECK_EQ(MAX31329::timeToEpoch(t), e);
+		CHECK_EQ(timegm(&ref), e);
+
+		MAX31329_PackedTime packed;
+		bool fits = packed.fromEpoch(e);
+		CHECK_EQ(fits, e - MAX31329_PackedTime::EPOCH_2000 <= (int64_t)UINT32_MAX);
+		if (fits) {
+			MAX31329_Time u;
+			packed.toTime(u);
+			CHECK_EQ(MAX31329::timeToEpoch(u), e);
+			CHECK(packed.fromTime(t));
+			CHECK_EQ(packed.toEpoch(), e);
+		}
+	}
+	MAX31329_PackedTime packed;
+	CHECK(!packed.fromEpoch(FIRST - 1));
+}
+
+// A sample of days through the BCD registers, both centuries
+static void testRegisters() {
+	for (int64_t day = 0; FIRST + day * 86400 < END; day += 97) {
+		int64_t e = FIRST + day * 86400 + (day * 7919) % 86400;
+		time_t te = (time_t)e;
+		struct tm ref;
+		gmtime_r(&te, &ref);
+
+		CHECK(rtc.writeEpoch(e));
+		CHECK_EQ(sim.epoch(), e);
+		CHECK_EQ(sim.peek(MAX31329_REG_SECONDS), MAX31329::binToBcd((uint8_t)ref.tm_sec));
+		CHECK_EQ(sim.peek(MAX31329_REG_DAY), ref.tm_wday + 1);
+		CHECK_EQ(sim.peek(MAX31329_REG_YEAR), MAX31329::binToBcd((uint8_t)(ref.tm_year % 100)));
+		CHECK_EQ((sim.peek(MAX31329_REG_MONTH) & MAX31329_MONTH_CENTURY) != 0, ref.tm_year >= 200);
+
+		int64_t back = 0;
+		CHECK(rtc.readEpoch(back));
+		CHECK_EQ(back, e);
+		struct tm tm;
+		CHECK(rtc.readTime(tm));
+		checkSameTm(tm, ref);
+		MAX31329_PackedTime packed;
+		CHECK_EQ(rtc.readTime(packed), e - MAX31329_PackedTime::EPOCH_2000 <= (int64_t)UINT32_MAX);
+	}
+	CHECK(!rtc.writeEpoch(FIRST - 1));
+	CHECK(!rtc.writeEpoch(END));
+	CHECK(rtc.writeEpoch(END - 1));
+	int64_t back = 0;
+	CHECK(rtc.readEpoch(back));
+	CHECK_EQ(back, END - 1);
+}
+
+// A month outside 1..12 leaves tm_yday at -1 instead of indexing past the table
+static void testBadMonth() {
+	MAX31329_Time t;
+	struct tm tm;
+	t.year = 2024;
+	t.month = 12;
+	t.day = 31;
+	t.toTm(tm);
+	CHECK_EQ(tm.tm_yday, 365);
+	t.month = 0;
+	t.toTm(tm);
+	CHECK_EQ(tm.tm_yday, -1);
+	t.month = 13;
+	t.toTm(tm);
+	CHECK_EQ(tm.tm_yday, -1);
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testConversions();
+	testRegisters();
+	testBadMonth();
+	return checkReport("test_epoch");
+}
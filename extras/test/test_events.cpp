@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_Events on the simulated device with its INT output wired to an
+// interrupt: one STATUS read per dispatch, and a STATUS read that fails
+// (NACK) leaves the edges pending so the latched event is still handled.
+
+#include <MAX31329_events.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static const uint8_t INT_PIN = 4;
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+static MAX31329_Events events(rtc);
+
+static uint32_t calls = 0;
+static uint32_t lastEdges = 0;
+
+static void isr() {
+	events.notifyFromISR();
+}
+
+static void onAlarm(uint8_t, uint32_t edges, void *) {
+	calls++;
+	lastEdges = edges;
+}
+
+static void testDispatch() {
+	CHECK(events.on(MAX31329_STATUS_A1F, onAlarm));
+	CHECK(rtc.setAlarm1(MAX31329_Alarm1::atSecond(30)));
+	CHECK(rtc.enableInterrupts(MAX31329_INT_A1IE));
+	CHECK(rtc.writeEpoch(1760000000));
+	uint8_t st;
+	CHECK(rtc.readStatus(st));
+	CHECK_EQ(events.dispatch(), 0);
+
+	MAX31329_SimClock::advance(31000000);
+	CHECK(sim.intAsserted());
+	CHECK_EQ(events.pendingEdges(), 1);
+	sim.resetCounters();
+	CHECK(events.dispatch() & MAX31329_STATUS_A1F);
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(calls, 1);
+	CHECK_EQ(lastEdges, 1);
+	CHECK_EQ(events.pendingEdges(), 0);
+	CHECK(!sim.intAsserted());
+}
+
+static void testFailedRead() {
+	calls = 0;
+	MAX31329_SimClock::advance(60000000);
+	CHECK(sim.intAsserted());
+	CHECK_EQ(events.pendingEdges(), 1);
+
+	// The read fails: nothing consumed, STATUS still latched, INT still low
+	sim.inject(MAX31329_SIM_FAULT_ADDR_NACK);
+	CHECK_EQ(events.dispatch(), -1);
+	CHECK_EQ(events.pendingEdges(), 1);
+	CHECK(sim.peek(MAX31329_REG_STATUS) & MAX31329_STATUS_A1F);
+	CHECK(sim.intAsserted());
+	CHECK_EQ(calls, 0);
+
+	// No new edge arrives, and the next dispatch still handles the event
+	CHECK(events.dispatch() & MAX31329_STATUS_A1F);
+	CHECK_EQ(calls, 1);
+	CHECK_EQ(lastEdges, 1);
+	CHECK_EQ(events.pendingEdges(), 0);
+	CHECK(!sim.intAsserted());
+	CHECK_EQ(events.dispatch(), 0);
+
+	// Overrun edges are counted once, by the read that succeeds
+	for (int i = 0; i < MAX31329_EVENT_QUEUE_LEN + 8; ++i) events.notifyFromISR();
+	sim.inject(MAX31329_SIM_FAULT_DATA_NACK, 2);
+	CHECK_EQ(events.dispatch(), -1);
+	CHECK_EQ(events.dispatch(), -1);
+	CHECK_EQ(events.overruns(), 0);
+	CHECK(events.dispatch() >= 0);
+	CHECK_EQ(events.overruns(), 8);
+	CHECK_EQ(events.pendingEdges(), 0);
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	sim.setIntPin(INT_PIN);
+	attachInterrupt(INT_PIN, isr, FALLING);
+	testDispatch();
+	testFailedRead();
+	return checkReport("test_events");
+}
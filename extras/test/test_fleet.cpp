@@ -0,0 +1,137 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_Fleet over five simulated devices at three addresses on two
+// Wire buses, grouped into three fleet buses: samples in add() order, a
+// bus whose devices time out, a poll timeout that keeps the buses that
+// finished and fails only the late ones, and the median vote.
+
+#include <MAX31329_fleet.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static const int64_t T = 1760000000;
+
+static MAX31329_Sim simA(0x68), simB(0x69), simC(0x68), simD(0x69), simE(0x6A);
+static MAX31329_Sim *const sims[] = {&simA, &simB, &simC, &simD, &simE};
+static MAX31329 rtcs[5];
+static const uint8_t BUS[5] = {0, 0, 1, 1, 2};
+static MAX31329_Fleet fleet;
+
+static void setEpochs(int64_t step) {
+	for (int i = 0; i < 5; ++i) sims[i]->setEpoch(T + i * step);
+}
+
+static void faults(MAX31329_SimFault fault, uint32_t n) {
+	simC.inject(fault, n);
+	simD.inject(fault, n);
+}
+
+static void testHealthy() {
+	setEpochs(10);
+	MAX31329_FleetSample out[5];
+	CHECK_EQ(fleet.poll(out, 100), 5);
+	for (int i = 0; i < 5; ++i) {
+		CHECK(out[i].ok);
+		CHECK_EQ(out[i].epochMs, (T + i * 10) * 1000);
+		if (i) CHECK(out[i].capturedUs > out[i - 1].capturedUs);
+	}
+	CHECK(fleet.lastPollUs() > 0);
+	CHECK(fleet.lastPollUs() < 100000);
+}
+
+static void testFaultedBus() {
+	// Every read on the second Wire bus times out, well inside the poll timeout
+	setEpochs(10);
+	faults(MAX31329_SIM_FAULT_TIMEOUT, 100);
+	MAX31329_FleetSample out[5];
+	CHECK_EQ(fleet.poll(out, 1000), 3);
+	CHECK(out[0].ok && out[1].ok && out[4].ok);
+	CHECK(!out[2].ok);
+	CHECK(!out[3].ok);
+	CHECK_EQ(out[4].epochMs, (T + 40) * 1000);
+	CHECK(fleet.lastPollUs() >= 100000);
+	faults(MAX31329_SIM_FAULT_NONE, 0);
+}
+
+static void testTimeout() {
+	// Fresh good samples everywhere first, so stale ones would show
+	MAX31329_FleetSample out[5];
+	setEpochs(10);
+	CHECK_EQ(fleet.poll(out, 100), 5);
+
+	// One 50 ms bus timeout on fleet bus 1 runs past a 30 ms poll: bus 0
+	// keeps its samples, bus 1 is late, and bus 2 is never reached
+	setEpochs(20);
+	simC.inject(MAX31329_SIM_FAULT_TIMEOUT);
+	simE.resetCounters();
+	CHECK_EQ(fleet.poll(out, 30), 2);
+	CHECK(out[0].ok && out[1].ok);
+	CHECK_EQ(out[0].epochMs, T * 1000);
+	CHECK_EQ(out[1].epochMs, (T + 20) * 1000);
+	CHECK(!out[2].ok);
+	CHECK(!out[3].ok);
+	CHECK(!out[4].ok);
+	CHECK_EQ(simE.counters().reads, 0);
+	CHECK(fleet.lastPollUs() > 30000);
+
+	// The next poll has them all back
+	CHECK_EQ(fleet.poll(out, 100), 5);
+	CHECK_EQ(out[4].epochMs, (T + 80) * 1000);
+}
+
+static void testMedian() {
+	setEpochs(0);
+	simD.setEpoch(T + 3600);
+	MAX31329_FleetSample out[5];
+	CHECK_EQ(fleet.poll(out, 100), 5);
+	int64_t ms = 0;
+	size_t agree = 0;
+	CHECK(MAX31329_Fleet::median(out, 5, out[0].capturedUs, 1000, ms, &agree));
+	CHECK_NEAR(ms, T * 1000, 1000);
+	CHECK_EQ(agree, 4);
+
+	// Two of three good samples off: no majority
+	simB.setEpoch(T + 7200);
+	simC.inject(MAX31329_SIM_FAULT_ADDR_NACK);
+	simE.inject(MAX31329_SIM_FAULT_ADDR_NACK);
+	CHECK_EQ(fleet.poll(out, 100), 3);
+	CHECK(!MAX31329_Fleet::median(out, 5, out[0].capturedUs, 1000, ms, &agree));
+	CHECK_EQ(agree, 1);
+}
+
+int main() {
+	Wire.attach(simA);
+	Wire.attach(simB);
+	Wire.attach(simE);
+	Wire1.attach(simC);
+	Wire1.attach(simD);
+	fleet.setMicrosSource(MAX31329_SimClock::now);
+	for (int i = 0; i < 5; ++i) {
+		rtcs[i].setAddress(sims[i]->address());
+		rtcs[i].setMicrosSource(MAX31329_SimClock::now);
+		CHECK(rtcs[i].begin(BUS[i] == 1 ? Wire1 : Wire));
+		CHECK_EQ(fleet.add(rtcs[i], BUS[i]), i);
+	}
+	CHECK(fleet.start());
+	testHealthy();
+	testFaultedBus();
+	testTimeout();
+	testMedian();
+	fleet.stop();
+	return checkReport("test_fleet");
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_Format and MAX31329_Stamper: exact output and length from a
+// decoded time and from the registers of the simulated device, across the
+// year and century rollovers, and the Stamper's prefix rebuilt on every
+// minute, hour and day change and reused in between.
+
+#include <MAX31329_format.h>
+
+#include <string.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static void expect(const char *got, size_t n, const char *want) {
+	if (n != strlen(want) || strcmp(got, want) != 0) printf("got \"%s\" (%zu), want \"%s\"\n", got, n, want);
+	CHECK_EQ(n, strlen(want));
+	CHECK(strcmp(got, want) == 0);
+}
+
+static void testTime() {
+	MAX31329_Time t;
+	t.year = 2025;
+	t.month = 11;
+	t.day = 24;
+	t.hour = 15;
+	t.minute = 30;
+	t.second = 7;
+	t.millisecond = 25;
+	char buf[MAX31329_FMT_MAX_LEN];
+	expect(buf, MAX31329_Format::iso8601(buf, sizeof(buf), t), "2025-11-24T15:30:07");
+	expect(buf, MAX31329_Format::iso8601(buf, sizeof(buf), t, MAX31329_FMT_MILLIS), "2025-11-24T15:30:07.025");
+	expect(buf, MAX31329_Format::iso8601(buf, sizeof(buf), t, MAX31329_FMT_MILLIS | MAX31329_FMT_UTC),
+		"2025-11-24T15:30:07.025Z");
+	expect(buf, MAX31329_Format::iso8601(buf, sizeof(buf), t, MAX31329_FMT_COMPACT), "20251124T153007");
+	expect(buf, MAX31329_Format::iso8601(buf, sizeof(buf), t, MAX31329_FMT_COMPACT | MAX31329_FMT_MILLIS),
+		"20251124T153007.025");
+	expect(buf, MAX31329_Format::timeOfDay(buf, sizeof(buf), t, MAX31329_FMT_MILLIS), "15:30:07.025");
+	expect(buf, MAX31329_Format::timeOfDay(buf, sizeof(buf), t, MAX31329_FMT_COMPACT), "153007");
+	CHECK_EQ(MAX31329_Format::length(MAX31329_FMT_MILLIS | MAX31329_FMT_UTC), MAX31329_FMT_MAX_LEN - 1);
+
+	// One byte short: nothing written
+	memset(buf, '#', sizeof(buf));
+	CHECK_EQ(MAX31329_Format::iso8601(buf, 19, t), 0);
+	CHECK_EQ(buf[0], '#');
+	CHECK_EQ(MAX31329_Format::iso8601(buf, 20, t), 19);
+	CHECK_EQ(MAX31329_Format::iso8601(nullptr, 32, t), 0);
+	t.year = 10000;
+	CHECK_EQ(MAX31329_Format::iso8601(buf, sizeof(buf), t), 0);
+}
+
+// The same instant formatted from the decoded epoch and from the registers
+static void both(int64_t epoch, const char *want) {
+	char buf[MAX31329_FMT_MAX_LEN];
+	MAX31329_Time t;
+	MAX31329::epochToTime(epoch, t);
+	expect(buf, MAX31329_Format::iso8601(buf, sizeof(buf), t, MAX31329_FMT_UTC), want);
+
+	uint8_t regs[7];
+	sim.setEpoch(epoch);
+	CHECK(rtc.readBytes(MAX31329_REG_SECONDS, regs, 7));
+	expect(buf, MAX31329_Format::iso8601Bcd(buf, sizeof(buf), regs, MAX31329_FMT_UTC), want);
+}
+
+static void testRollover() {
+	both(946684800, "2000-01-01T00:00:00Z");
+	both(1767225599, "2025-12-31T23:59:59Z");
+	both(1767225600, "2026-01-01T00:00:00Z");
+	both(4102444799, "2099-12-31T23:59:59Z");
+	both(4102444800, "2100-01-01T00:00:00Z");
+	both(4102531200, "2100-01-02T00:00:00Z");
+	both(951782400, "2000-02-29T00:00:00Z");
+
+	// The device ticks across the century; the BCD path follows the century bit
+	char buf[MAX31329_FMT_MAX_LEN];
+	uint8_t regs[7];
+	sim.setEpoch(4102444799);
+	MAX31329_SimClock::advance(1000000);
+	CHECK(rtc.readBytes(MAX31329_REG_SECONDS, regs, 7));
+	CHECK(regs[5] & 0x80);
+	expect(buf, MAX31329_Format::iso8601Bcd(buf, sizeof(buf), regs, MAX31329_FMT_MILLIS),
+		"2100-01-01T00:00:00.000");
+	expect(buf, MAX31329_Format::iso8601Bcd(buf, sizeof(buf), regs, MAX31329_FMT_COMPACT),
+		"21000101T000000");
+	CHECK_EQ(MAX31329_Format::iso8601Bcd(buf, 23, regs, MAX31329_FMT_MILLIS), 0);
+}
+
+static void testStamper() {
+	MAX31329_Stamper stamper;
+	char buf[MAX31329_FMT_MAX_LEN], ref[MAX31329_FMT_MAX_LEN];
+	const int64_t start = 1767225538500LL; // 2025-12-31T23:58:58.500Z
+	expect(buf, stamper.stamp(buf, sizeof(buf), start), "2025-12-31T23:58:58.500Z");
+	CHECK_EQ(stamper.prefixRebuilds(), 1);
+	expect(buf, stamper.stamp(buf, sizeof(buf), start + 1499), "2025-12-31T23:58:59.999Z");
+	CHECK_EQ(stamper.prefixRebuilds(), 1);
+	// Minute, then year and day
+	expect(buf, stamper.stamp(buf, sizeof(buf), start + 1500), "2025-12-31T23:59:00.000Z");
+	CHECK_EQ(stamper.prefixRebuilds(), 2);
+	expect(buf, stamper.stamp(buf, sizeof(buf), start + 61500), "2026-01-01T00:00:00.000Z");
+	CHECK_EQ(stamper.prefixRebuilds(), 3);
+	// Hour, with the same minute digits
+	expect(buf, stamper.stamp(buf, sizeof(buf), start + 3661500), "2026-01-01T01:00:00.000Z");
+	CHECK_EQ(stamper.prefixRebuilds(), 4);
+	// Back in time rebuilds too
+	expect(buf, stamper.stamp(buf, sizeof(buf), start), "2025-12-31T23:58:58.500Z");
+	CHECK_EQ(stamper.prefixRebuilds(), 5);
+
+	// Three hours of records every 997 ms: one rebuild per minute
+	MAX31329_Stamper sweep(MAX31329_FMT_MILLIS);
+	uint32_t wrong = 0, minutes = 0;
+	int64_t lastMinute = -1;
+	for (int64_t ms = start; ms < start + 3 * 3600000; ms += 997) {
+		MAX31329_Time t;
+		MAX31329::epochToTime(ms / 1000, t);
+		t.millisecond = (int)(ms % 1000);
+		size_t n = sweep.stamp(buf, sizeof(buf), ms);
+		MAX31329_Format::iso8601(ref, sizeof(ref), t, MAX31329_FMT_MILLIS);
+		if (n != 23 || strcmp(buf, ref) != 0) wrong++;
+		if (ms / 60000 != lastMinute) minutes++;
+		lastMinute = ms / 60000;
+	}
+	CHECK_EQ(wrong, 0);
+	CHECK_EQ(sweep.prefixRebuilds(), minutes);
+
+	// Decoded input, compact
+	MAX31329_Stamper compact(MAX31329_FMT_COMPACT);
+	MAX31329_Time t;
+	MAX31329::epochToTime(4102444799, t);
+	expect(buf, compact.stamp(buf, sizeof(buf), t), "20991231T235959");
+	MAX31329::epochToTime(4102444800, t);
+	expect(buf, compact.stamp(buf, sizeof(buf), t), "21000101T000000");
+	t.second = 30;
+	expect(buf, compact.stamp(buf, sizeof(buf), t), "21000101T000030");
+	t.hour = 1;
+	expect(buf, compact.stamp(buf, sizeof(buf), t), "21000101T010030");
+	CHECK_EQ(compact.prefixRebuilds(), 3);
+	CHECK_EQ(compact.stamp(buf, 15, t), 0);
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testTime();
+	testRollover();
+	testStamper();
+	return checkReport("test_format");
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_NvStore on the simulated device: records, the diff-only commit,
+// and power loss at every byte of every burst of a commit. A torn commit
+// must load as the previous state, and the next commit must repair the
+// torn bytes even when they now match what the mirror last wrote.
+
+#include <MAX31329_nvstore.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static const uint8_t OFFSET = 8;
+static const uint8_t LENGTH = 48;
+
+struct State {
+	uint32_t a;
+	uint16_t b;
+	uint8_t c[5];
+};
+
+static void put(MAX31329_NvStore &s, const State &st) {
+	CHECK(s.put(1, st.a));
+	CHECK(s.put(2, st.b));
+	CHECK(s.put(3, st.c));
+}
+
+static bool equals(const MAX31329_NvStore &s, const State &st) {
+	State got;
+	return s.get(1, got.a) && got.a == st.a && s.get(2, got.b) && got.b == st.b &&
+		s.get(3, got.c) && memcmp(got.c, st.c, sizeof(st.c)) == 0;
+}
+
+static void saveRam(uint8_t *ram) {
+	for (uint8_t i = 0; i < MAX31329_RAM_SIZE; ++i) ram[i] = sim.peek((uint8_t)(MAX31329_REG_RAM_START + i));
+}
+
+static void restoreRam(const uint8_t *ram) {
+	for (uint8_t i = 0; i < MAX31329_RAM_SIZE; ++i) sim.poke((uint8_t)(MAX31329_REG_RAM_START + i), ram[i]);
+}
+
+static const State S1 = {0x11111111, 0x1111, {1, 1, 1, 1, 1}};
+static const State S2 = {0x22222222, 0x1111, {2, 2, 2, 2, 2}};
+static const State S3 = {0x33333333, 0x3333, {1, 3, 1, 3, 1}};
+
+static void testRecords() {
+	uint8_t zero[MAX31329_RAM_SIZE] = {0};
+	CHECK(rtc.writeRam(0, zero, sizeof(zero)));
+	MAX31329_NvStore s(rtc, OFFSET, LENGTH);
+	CHECK(s.load());
+	CHECK_EQ(s.size(1), -1);
+	put(s, S1);
+	CHECK(s.dirty());
+	size_t bytes = 0;
+	CHECK(s.commit(&bytes));
+	CHECK(bytes > 0);
+	CHECK(!s.dirty());
+
+	// The bytes outside the window are never touched
+	for (uint8_t i = 0; i < OFFSET; ++i) CHECK_EQ(sim.peek((uint8_t)(MAX31329_REG_RAM_START + i)), 0);
+
+	// A same-size update rewrites only the changed data and its CRC
+	put(s, S2);
+	CHECK(s.commit());
+	put(s, S2);
+	CHECK(!s.dirty());
+	MAX31329_NvStore fresh(rtc, OFFSET, LENGTH);
+	CHECK(fresh.load());
+	CHECK(equals(fresh, S2));
+	CHECK_EQ(fresh.sequence(), s.sequence());
+	CHECK(!fresh.put(0xFF, S1.a));
+	CHECK(fresh.remove(2));
+	CHECK_EQ(fresh.size(2), -1);
+	CHECK(!fresh.remove(2));
+}
+
+// Power lost after `skip` complete bursts and `n` bytes of the next one
+static void testTorn() {
+	MAX31329_NvStore setup(rtc, OFFSET, LENGTH);
+	CHECK(setup.load());
+	put(setup, S1);
+	CHECK(setup.commit());
+	put(setup, S2);
+	CHECK(setup.commit());
+	uint8_t before[MAX31329_RAM_SIZE];
+	saveRam(before);
+
+	// The clean commit of S3, for its burst sizes
+	MAX31329_NvStore clean(rtc, OFFSET, LENGTH);
+	CHECK(clean.load());
+	put(clean, S3);
+	sim.resetCounters();
+	CHECK(clean.commit());
+	uint32_t bursts = sim.counters().writes;
+	CHECK(bursts >= 2);
+
+	uint32_t torn = 0;
+	for (uint32_t k = 0; k < bursts; ++k) {
+		for (size_t n = 0; n < LENGTH; ++n) {
+			restoreRam(before);
+			MAX31329_NvStore s(rtc, OFFSET, LENGTH);
+			CHECK(s.load());
+			CHECK(equals(s, S2));
+			uint8_t oldSeq = s.sequence();
+			put(s, S3);
+			sim.tearNextWrite(n, k);
+			if (s.commit()) {
+				sim.tearNextWrite(LENGTH); // n covered the whole burst: disarm
+				break;
+			}
+			torn++;
+
+			// Never a mix: the previous state, from the previous bank
+			MAX31329_NvStore after(rtc, OFFSET, LENGTH);
+			CHECK(after.load());
+			CHECK(equals(after, S2));
+			CHECK_EQ(after.sequence(), oldSeq);
+
+			// Back to S2 without a reload: bytes the torn burst changed must
+			// be rewritten even where S2 matches the mirror
+			put(s, S2);
+			CHECK(s.commit());
+			MAX31329_NvStore again(rtc, OFFSET, LENGTH);
+			CHECK(again.load());
+			CHECK(equals(again, S2));
+			CHECK_EQ(again.sequence(), s.sequence());
+			CHECK_EQ(again.sequence(), (uint8_t)(oldSeq + 1));
+		}
+	}
+	CHECK(torn >= bursts);
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testRecords();
+	testTorn();
+	return checkReport("test_nvstore");
+}
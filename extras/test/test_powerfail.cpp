@@ -0,0 +1,135 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_PowerFail on the simulated device: the commit from the PFAIL
+// handler, arm/restore states, and a commit burst torn after every possible
+// byte, which must never restore as committed.
+
+#include <MAX31329_powerfail.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+struct State {
+	uint32_t counter;
+	uint8_t tag[6];
+};
+
+static const uint8_t OFFSET = 48;
+static const uint8_t SIZE = 16;
+
+static State make(uint32_t counter) {
+	State s;
+	s.counter = counter;
+	for (uint8_t i = 0; i < sizeof(s.tag); ++i) s.tag[i] = (uint8_t)(counter * 3 + i);
+	return s;
+}
+
+static bool same(const State &a, const State &b) {
+	return memcmp(&a, &b, sizeof(State)) == 0;
+}
+
+static void testStates() {
+	uint8_t zero[SIZE] = {0};
+	CHECK(rtc.writeRam(OFFSET, zero, SIZE));
+	MAX31329_PowerFail pf(rtc, OFFSET, SIZE);
+	State got;
+	uint8_t len = 0;
+	CHECK_EQ(pf.restore(&got, sizeof(got), &len), MAX31329_PF_INVALID);
+	CHECK_EQ(len, 0);
+
+	// The commit runs from the PFAIL handler and fills the whole region
+	MAX31329_Events events(rtc);
+	pf.attach(events);
+	CHECK(pf.arm());
+	CHECK(sim.peek(MAX31329_REG_INT_EN) & MAX31329_INT_PFAILE);
+	State saved = make(7);
+	CHECK(pf.stage(saved));
+	sim.resetCounters();
+	sim.setPowerFail(true);
+	CHECK(events.dispatch(true) & MAX31329_STATUS_PFAIL);
+	sim.setPowerFail(false);
+	CHECK_EQ(pf.commits(), 1);
+	CHECK_EQ(sim.counters().writes, 1);
+	CHECK_EQ(sim.counters().bytesWritten, SIZE);
+
+	MAX31329_PowerFail boot(rtc, OFFSET, SIZE);
+	CHECK_EQ(boot.restore(&got, sizeof(got), &len), MAX31329_PF_COMMITTED);
+	CHECK_EQ(len, sizeof(State));
+	CHECK(same(got, saved));
+
+	// Armed: the old payload is still verifiable
+	CHECK(boot.arm());
+	CHECK_EQ(boot.restore(&got, sizeof(got)), MAX31329_PF_ARMED);
+	CHECK(same(got, saved));
+
+	// A bit flip anywhere in the record is caught
+	uint8_t b = sim.peek((uint8_t)(MAX31329_REG_RAM_START + OFFSET + 3));
+	sim.poke((uint8_t)(MAX31329_REG_RAM_START + OFFSET + 3), (uint8_t)(b ^ 0x10));
+	CHECK_EQ(boot.restore(&got, sizeof(got)), MAX31329_PF_INVALID);
+	sim.poke((uint8_t)(MAX31329_REG_RAM_START + OFFSET + 3), b);
+
+	// Payloads longer than the region allows are refused
+	uint8_t big[SIZE - MAX31329_PF_OVERHEAD + 1] = {0};
+	CHECK(!boot.stage(big, sizeof(big)));
+	CHECK(boot.stage(big, sizeof(big) - 1));
+}
+
+// Power lost n bytes into the burst, for every n: the record is never
+// reported committed, and an untouched one still restores as armed
+static void testTorn() {
+	MAX31329_PowerFail pf(rtc, OFFSET, SIZE);
+	State old = make(100);
+	CHECK(pf.stage(old));
+	CHECK(pf.commit());
+	for (uint8_t n = 0; n < SIZE; ++n) {
+		MAX31329_PowerFail boot(rtc, OFFSET, SIZE);
+		State got;
+		CHECK_EQ(boot.restore(&got, sizeof(got)), MAX31329_PF_COMMITTED);
+		CHECK(boot.arm());
+
+		State next = make(200 + n);
+		CHECK(boot.stage(next));
+		sim.tearNextWrite(n);
+		CHECK(!boot.commit());
+
+		MAX31329_PowerFail after(rtc, OFFSET, SIZE);
+		MAX31329_PowerFailState st = after.restore(&got, sizeof(got));
+		CHECK(st != MAX31329_PF_COMMITTED);
+		if (n == 0) {
+			CHECK_EQ(st, MAX31329_PF_ARMED);
+			CHECK(same(got, old));
+		} else {
+			CHECK_EQ(st, MAX31329_PF_INVALID);
+		}
+
+		// The next boot commits a fresh record over the torn one
+		CHECK(pf.stage(old));
+		CHECK(pf.commit());
+	}
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testStates();
+	testTorn();
+	return checkReport("test_powerfail");
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// writeTimePrecise() on the virtual clock: the simulated RTC's second must
+// roll over in phase with the reference, at any starting phase and bus
+// speed, and the reported residual must cover the actual offset. The waits
+// must sleep rather than spin on the clock.
+
+#include <kode_MAX31329.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+
+static uint32_t spins = 0;
+
+// A spinning CPU: every clock read costs a microsecond
+static int64_t spinMicros() {
+	spins++;
+	MAX31329_SimClock::advance(1);
+	return MAX31329_SimClock::now();
+}
+
+// RTC minus reference, microseconds
+static int64_t offsetUs(int64_t refEpochUs, int64_t capturedAt) {
+	int64_t refNow = refEpochUs + (MAX31329_SimClock::now() - capturedAt);
+	return sim.epochUs() - refNow;
+}
+
+static void run(MAX31329 &rtc, uint32_t frequency) {
+	CHECK(rtc.begin(frequency));
+	for (int i = 0; i < 20; ++i) {
+		// Leave the RTC and the reference at unrelated phases
+		MAX31329_SimClock::advance(37123 * (i + 1));
+		sim.setEpoch(1700000000 + i);
+		MAX31329_SimClock::advance(100003 * i % 1000000);
+		int64_t ref = (1760000000LL + i * 3600) * 1000000 + (i * 48271) % 1000000;
+		int64_t capturedAt = MAX31329_SimClock::now();
+
+		int32_t residual = 0;
+		uint32_t residualErr = 0;
+		int64_t start = MAX31329_SimClock::now();
+		spins = 0;
+		CHECK(rtc.writeTimePrecise(ref, capturedAt, &residual, &residualErr));
+		CHECK(MAX31329_SimClock::now() - start < 2100000);
+		// The waits sleep in delay(): the clock is spun only near the two edges
+		CHECK(spins < 5000);
+
+		int64_t off = offsetUs(ref, capturedAt);
+		CHECK(off > -150 && off < 150);
+		// Bracketed by two one-byte reads: about 40 bit times
+		CHECK(residualErr <= 42000000 / frequency);
+		CHECK(residual - (int64_t)residualErr <= off + 2 && off - 2 <= residual + (int64_t)residualErr);
+
+		// The interpolation anchor is seeded from the measured edge
+		int64_t ms;
+		uint32_t errMs;
+		CHECK(rtc.readEpochMs(ms, &errMs));
+		int64_t refMs = (ref + (MAX31329_SimClock::now() - capturedAt)) / 1000;
+		CHECK(ms - refMs <= (int64_t)errMs + 1 && refMs - ms <= (int64_t)errMs + 1);
+	}
+}
+
+int main() {
+	Wire.attach(sim);
+
+	MAX31329 rtc;
+	rtc.setMicrosSource(spinMicros);
+	CHECK(rtc.begin());
+	CHECK(rtc.enableFastTime(60000, 20));
+	run(rtc, 400000U);
+	run(rtc, 100000U);
+
+	// writeEpochMs() lands on the same phase without the residual poll
+	int64_t ms = 1760000000123LL;
+	int64_t capturedAt = MAX31329_SimClock::now();
+	CHECK(rtc.writeEpochMs(ms));
+	int64_t off = offsetUs(ms * 1000, capturedAt);
+	CHECK(off > -1200 && off < 1200);
+
+	return checkReport("test_precise");
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_Profile on the simulated device: the bus cost of capture() and
+// apply() (the reads and write bursts the README quotes), a no-op re-apply,
+// the serialized form, and the registers a profile must never write.
+
+#include <MAX31329_profile.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static uint8_t pattern[MAX31329_RAM_SIZE];
+
+// A board setup touching every covered register group
+static void configure() {
+	CHECK(rtc.setAlarm1(MAX31329_Alarm1::atHour(7, 30, 0)));
+	CHECK(rtc.setAlarm2(MAX31329_Alarm2::onDay(1, 9, 0)));
+	CHECK(rtc.timerConfigure(100, true, 2));
+	CHECK(rtc.trickleEnable(0x5));
+	CHECK(rtc.enableInterrupts(MAX31329_INT_A1IE | MAX31329_INT_A2IE));
+	for (uint8_t i = 0; i < MAX31329_RAM_SIZE; ++i) pattern[i] = (uint8_t)(i * 37 + 1);
+	CHECK(rtc.writeRam(0, pattern, sizeof(pattern)));
+}
+
+// Power-on defaults; NVRAM is battery backed, so clear it as well
+static void freshUnit() {
+	sim.powerOn();
+	uint8_t zero[MAX31329_RAM_SIZE] = {0};
+	CHECK(rtc.writeRam(0, zero, sizeof(zero)));
+}
+
+static void testCaptureApply() {
+	configure();
+	MAX31329_Profile golden;
+	sim.resetCounters();
+	CHECK(golden.capture(rtc, true));
+	CHECK_EQ(sim.counters().reads, 2);
+	CHECK_EQ(sim.counters().writes, 0);
+	CHECK_EQ(sim.counters().bytesRead, 25 + MAX31329_RAM_SIZE);
+	CHECK(golden.hasRam());
+	CHECK_EQ(golden.verify(rtc), 0);
+
+	// Power-on unit: 2 reads and 5 bursts. The alarms and the timer/power
+	// bytes are two runs split by TIMER_COUNT; INT_EN and TIMER_CONFIG are
+	// two more, three unchanged bytes apart; then NVRAM.
+	freshUnit();
+	CHECK(golden.verify(rtc) > 0);
+	int64_t before = sim.epoch();
+	size_t bytes = 0, bursts = 0;
+	sim.resetCounters();
+	CHECK(golden.apply(rtc, &bytes, &bursts));
+	CHECK_EQ(sim.counters().reads, 2);
+	CHECK_EQ(sim.counters().writes, 5);
+	CHECK_EQ(bursts, 5);
+	CHECK_EQ(bytes, sim.counters().bytesWritten);
+	CHECK_EQ(golden.verify(rtc), 0);
+	CHECK(sim.epoch() - before <= 1); // the time registers are left alone
+	uint8_t ram[MAX31329_RAM_SIZE];
+	CHECK(rtc.readRam(0, ram, sizeof(ram)));
+	CHECK(memcmp(ram, pattern, sizeof(ram)) == 0);
+
+	// Already matching: the reads only
+	sim.resetCounters();
+	CHECK(golden.apply(rtc, &bytes, &bursts));
+	CHECK_EQ(sim.counters().reads, 2);
+	CHECK_EQ(sim.counters().writes, 0);
+	CHECK_EQ(bytes, 0);
+	CHECK_EQ(bursts, 0);
+
+	// One changed register is one single-byte burst
+	MAX31329_Profile edited = golden;
+	CHECK(edited.set(MAX31329_REG_TRICKLE, 0x6));
+	CHECK_EQ(edited.diff(golden), 1);
+	sim.resetCounters();
+	CHECK(edited.apply(rtc, &bytes, &bursts));
+	CHECK_EQ(bursts, 1);
+	CHECK_EQ(bytes, 1);
+	CHECK_EQ(sim.peek(MAX31329_REG_TRICKLE), 0x6);
+
+	// Without NVRAM: one read and one burst fewer
+	MAX31329_Profile regsOnly;
+	freshUnit();
+	configure();
+	CHECK(regsOnly.capture(rtc));
+	freshUnit();
+	sim.resetCounters();
+	CHECK(regsOnly.apply(rtc, &bytes, &bursts));
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(bursts, 4);
+}
+
+static void testSerialize() {
+	MAX31329_Profile p;
+	CHECK(p.capture(rtc, true));
+	uint8_t blob[MAX31329_PROFILE_SIZE(true)];
+	CHECK_EQ(p.serialize(blob, sizeof(blob) - 1), 0);
+	size_t len = p.serialize(blob, sizeof(blob));
+	CHECK_EQ(len, sizeof(blob));
+
+	MAX31329_Profile q;
+	CHECK(q.deserialize(blob, len));
+	CHECK(q.hasRam());
+	CHECK_EQ(q.diff(p), 0);
+	CHECK(!q.deserialize(blob, len - 1));
+	blob[10] ^= 0x01;
+	CHECK(!q.deserialize(blob, len));
+	blob[10] ^= 0x01;
+	blob[0] = MAX31329_PROFILE_VERSION + 1;
+	CHECK(!q.deserialize(blob, len));
+
+	// SWRST is masked and TIMER_COUNT is read-only
+	uint8_t v = 0;
+	CHECK(q.set(MAX31329_REG_RTC_RESET, MAX31329_RESET_SWRST));
+	CHECK(q.get(MAX31329_REG_RTC_RESET, v));
+	CHECK_EQ(v, 0);
+	CHECK(!q.set(MAX31329_REG_TIMER_COUNT, 1));
+	CHECK(!q.set(MAX31329_REG_SECONDS, 1));
+	CHECK(!q.get(MAX31329_REG_SECONDS, v));
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testCaptureApply();
+	testSerialize();
+	return checkReport("test_profile");
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_Publisher seqlock under contention: one poller thread publishes
+// as fast as it can while four reader threads copy the published time. The
+// host start() is a no-op, so the test drives publish() itself. Every
+// publish moves the virtual clock by whole seconds, so a copy torn between
+// two publishes shows up as an RTC time that disagrees with its capture time.
+
+#include <MAX31329_publisher.h>
+
+#include <atomic>
+#include <thread>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static const int PUBLISHES = 100000;
+static const int READERS = 4;
+
+struct ReaderResult {
+	uint32_t reads = 0;
+	uint32_t misses = 0;
+	uint32_t torn = 0;
+	uint32_t backwards = 0;
+};
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	CHECK(rtc.writeEpoch(1760000000));
+	// RTC seconds minus capture time; a consistent copy is within one second
+	const int64_t offsetUs = 1760000000LL * 1000000 - MAX31329_SimClock::now();
+
+	MAX31329_Publisher pub(rtc);
+	pub.setMicrosSource(MAX31329_SimClock::now);
+	MAX31329_PublishedTime p;
+	CHECK(!pub.read(p));
+	CHECK(pub.start(10)); // no task on the host
+	CHECK(pub.publish());
+	CHECK(pub.read(p));
+	CHECK_EQ(p.sequence, 1);
+
+	std::atomic<bool> done(false);
+	ReaderResult results[READERS];
+	std::thread readers[READERS];
+	for (int r = 0; r < READERS; ++r) {
+		readers[r] = std::thread([&pub, &done, &results, offsetUs, r]() {
+			ReaderResult &res = results[r];
+			uint32_t lastSeq = 0;
+			int64_t lastMs = 0;
+			while (!done.load(std::memory_order_acquire)) {
+				MAX31329_PublishedTime t;
+				if (!pub.read(t)) {
+					res.misses++;
+					continue;
+				}
+				res.reads++;
+				int64_t skew = t.epochMs * 1000 - t.capturedUs - offsetUs;
+				if (skew > 0 || skew < -1000000 || t.failures != 0 || t.errorMs != 1000) res.torn++;
+				if (t.sequence < lastSeq || (t.sequence > lastSeq && t.epochMs <= lastMs)) res.backwards++;
+				lastSeq = t.sequence;
+				lastMs = t.epochMs;
+			}
+		});
+	}
+
+	// Poller: 1..4 s of virtual time between publishes
+	for (int i = 0; i < PUBLISHES; ++i) {
+		MAX31329_SimClock::advance(1000000LL * (1 + i % 4));
+		CHECK(pub.publish());
+	}
+	done.store(true, std::memory_order_release);
+	for (int r = 0; r < READERS; ++r) readers[r].join();
+
+	uint32_t reads = 0;
+	for (int r = 0; r < READERS; ++r) {
+		reads += results[r].reads;
+		CHECK_EQ(results[r].torn, 0);
+		CHECK_EQ(results[r].backwards, 0);
+	}
+	CHECK(reads > 0);
+	CHECK(pub.read(p));
+	CHECK_EQ(p.sequence, PUBLISHES + 1);
+	printf("%u reads, %u reader retries\n", reads, pub.readerRetries());
+
+	// A failed poll is published with the last good time
+	sim.inject(MAX31329_SIM_FAULT_ADDR_NACK);
+	CHECK(!pub.publish());
+	CHECK(pub.read(p));
+	CHECK_EQ(p.failures, 1);
+	CHECK_EQ(p.sequence, PUBLISHES + 2);
+	pub.stop();
+
+	return checkReport("test_publisher");
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_Scheduler on the simulated device: deadline ordering through the
+// heap, stale ids, the bus cost of a rearm, the interrupt enables when the
+// nearest deadline moves between Alarm1 and the timer, timer and Alarm1
+// wakes driven by the device INT output, and Alarm1 placement under a
+// drift trim.
+
+#include <MAX31329_scheduler.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static int64_t ran[64];
+static int ranCount = 0;
+
+static void record(void *arg) {
+	if (ranCount < 64) ran[ranCount++] = (int64_t)(intptr_t)arg;
+}
+
+static int64_t nowMs() {
+	int64_t ms = 0;
+	CHECK(rtc.readEpochMs(ms));
+	return ms;
+}
+
+// Advance until the device asserts INT, at most limitMs
+static int64_t waitInt(int64_t limitMs) {
+	int64_t waited = 0;
+	while (!sim.intAsserted() && waited < limitMs) {
+		MAX31329_SimClock::advance(1000);
+		waited++;
+	}
+	return waited;
+}
+
+static void testOrdering() {
+	MAX31329_Scheduler sched(rtc);
+	int64_t base = nowMs() + 100000;
+	// A scrambled permutation of 0..23
+	int ids[24];
+	for (int i = 0; i < 24; ++i) {
+		int k = (i * 7) % 24;
+		ids[k] = sched.add(base + k * 1000, record, (void *)(intptr_t)k);
+		CHECK(ids[k] >= 0);
+	}
+	CHECK_EQ(sched.pending(), 24);
+	int64_t next = 0;
+	CHECK(sched.nextDeadline(next));
+	CHECK_EQ(next, base);
+
+	// Cancel every third job; cancelling twice or with a stale id fails
+	for (int k = 0; k < 24; k += 3) CHECK(sched.cancel(ids[k]));
+	CHECK(!sched.cancel(ids[0]));
+	int reused = sched.add(base + 500, record, (void *)(intptr_t)100);
+	CHECK(reused >= 0 && (reused & 0xFF) == (ids[0] & 0xFF));
+	CHECK(!sched.cancel(ids[0]));
+	CHECK(sched.cancel(reused));
+	CHECK_EQ(sched.pending(), 16);
+	CHECK(sched.nextDeadline(next));
+	CHECK_EQ(next, base + 1000);
+
+	// Everything due at once runs in deadline order
+	sched.setTolerance(60000);
+	CHECK(rtc.writeEpoch(base / 1000 + 24));
+	ranCount = 0;
+	CHECK_EQ(sched.service(), 16);
+	CHECK_EQ(ranCount, 16);
+	for (int i = 1; i < ranCount; ++i) CHECK(ran[i - 1] < ran[i]);
+	for (int i = 0; i < ranCount; ++i) CHECK(ran[i] % 3 != 0);
+	CHECK_EQ(sched.pending(), 0);
+
+	// The heap holds up to MAX31329_SCHEDULER_MAX_JOBS
+	for (int i = 0; i < MAX31329_SCHEDULER_MAX_JOBS; ++i)
+		CHECK(sched.add(base + 1000000 - i, record) >= 0);
+	CHECK_EQ(sched.add(base, record), -1);
+	CHECK(sched.nextDeadline(next));
+	CHECK_EQ(next, base + 1000000 - (MAX31329_SCHEDULER_MAX_JOBS - 1));
+	sched.clear();
+	CHECK_EQ(sched.pending(), 0);
+}
+
+// A rearm onto the timer is one commit: three writes (TE clear, TIMER_INIT,
+// TE set) after the time read, and no register reads with the shadow cache.
+// The first arm also enables the interrupts.
+static void testRearmCost() {
+	sim.powerOn();
+	CHECK(rtc.writeEpoch(1760000000));
+	rtc.setShadowCache(true);
+	CHECK(rtc.shadowResync());
+	MAX31329_Scheduler sched(rtc);
+	int64_t now = nowMs();
+	sched.add(now + 3000, record, (void *)(intptr_t)1);
+
+	sim.resetCounters();
+	CHECK(sched.arm());
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(sim.counters().writes, 4);
+	CHECK(sim.peek(MAX31329_REG_INT_EN) & MAX31329_INT_TIE);
+
+	// Armed for the same deadline: only the time read
+	sim.resetCounters();
+	CHECK(sched.arm());
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(sim.counters().writes, 0);
+
+	// A nearer job restarts the running timer, same cost
+	sched.add(now + 1000, record, (void *)(intptr_t)2);
+	sim.resetCounters();
+	CHECK(sched.arm());
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(sim.counters().writes, 3);
+
+	// Without the shadow the commit adds one read of TIMER_CONFIG
+	rtc.setShadowCache(false);
+	sched.add(now + 500, record, (void *)(intptr_t)3);
+	sim.resetCounters();
+	CHECK(sched.arm());
+	CHECK_EQ(sim.counters().reads, 2);
+	CHECK_EQ(sim.counters().writes, 3);
+	sched.clear();
+}
+
+// Only the source armed for the nearest deadline is enabled: moving between
+// Alarm1 and the timer stops the timer or silences Alarm1 in the same commit
+static void testSwitch() {
+	const uint8_t both = MAX31329_INT_A1IE | MAX31329_INT_TIE;
+	sim.powerOn();
+	CHECK(rtc.writeEpoch(1760000000));
+	uint8_t st;
+	CHECK(rtc.readStatus(st));
+	MAX31329_Scheduler sched(rtc);
+	int64_t now = nowMs();
+	sched.add(now + 120000, record, (void *)(intptr_t)1);
+	CHECK(sched.arm());
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN) & both, MAX31329_INT_A1IE);
+	CHECK(!(sim.peek(MAX31329_REG_TIMER_CONFIG) & MAX31329_TMR_TE));
+
+	// A near job: the timer commit also turns A1IE off, at no extra write
+	int near = sched.add(now + 5000, record, (void *)(intptr_t)2);
+	sim.resetCounters();
+	CHECK(sched.arm());
+	CHECK_EQ(sim.counters().writes, 3);
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN) & both, MAX31329_INT_TIE);
+	CHECK(sim.peek(MAX31329_REG_TIMER_CONFIG) & MAX31329_TMR_TE);
+
+	// Cancelled: back to Alarm1, with the timer stopped and TIE off
+	CHECK(sched.cancel(near));
+	CHECK(sched.arm());
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN) & both, MAX31329_INT_A1IE);
+	CHECK(!(sim.peek(MAX31329_REG_TIMER_CONFIG) & MAX31329_TMR_TE));
+
+	// Nothing wakes at the cancelled deadline; Alarm1 wakes at the far one
+	ranCount = 0;
+	CHECK_EQ(waitInt(10000), 10000);
+	CHECK(waitInt(120000) < 120000);
+	CHECK(rtc.readStatus(st));
+	CHECK(st & MAX31329_STATUS_A1F);
+	CHECK(!(st & MAX31329_STATUS_TIF));
+	CHECK_EQ(sched.service(), 1);
+	CHECK_EQ(ranCount, 1);
+	CHECK_EQ(ran[0], 1);
+}
+
+// Wakes on INT: the timer for near jobs, Alarm1 for far ones
+static void testWakes() {
+	sim.powerOn();
+	CHECK(rtc.writeEpoch(1760000000));
+	uint8_t st;
+	CHECK(rtc.readStatus(st));
+	MAX31329_Scheduler sched(rtc);
+	int64_t start = nowMs();
+	sched.add(start + 2000, record, (void *)(intptr_t)1, 2000);
+	sched.add(start + 60000, record, (void *)(intptr_t)2);
+	CHECK(sched.arm());
+
+	ranCount = 0;
+	for (int wake = 0; wake < 30 && ranCount < 31; ++wake) {
+		int64_t waited = waitInt(120000);
+		CHECK(waited < 120000);
+		CHECK(rtc.readStatus(st));
+		CHECK(sched.service() >= 0);
+	}
+	// 30 periodic runs at 2 s by the 60 s mark, plus the one-shot
+	int periodic = 0, oneShot = 0;
+	for (int i = 0; i < ranCount; ++i) {
+		if (ran[i] == 1) periodic++;
+		if (ran[i] == 2) oneShot++;
+	}
+	CHECK_EQ(periodic, 30);
+	CHECK_EQ(oneShot, 1);
+	int64_t elapsed = nowMs() - start;
+	CHECK(elapsed >= 60000 && elapsed < 61000);
+
+	// Far deadlines go to Alarm1 in raw RTC time. With the RTC 5 s ahead
+	// the alarm holds the deadline plus 5 s, so the job runs on trimmed time.
+	sched.clear();
+	int64_t raw = 0;
+	CHECK(rtc.readEpoch(raw));
+	rtc.setTrim(raw * 1000000, 5000000, 0);
+	int64_t trimmed = nowMs();
+	CHECK_EQ(trimmed, raw * 1000 - 5000);
+	sched.add(trimmed + 600000, record, (void *)(intptr_t)3);
+	CHECK(sched.arm());
+	CHECK(rtc.readStatus(st));
+	MAX31329_Alarm1 alarm;
+	CHECK(rtc.readAlarm1(alarm));
+	MAX31329_Time at;
+	MAX31329::epochToTime((trimmed + 600000) / 1000 + 5, at);
+	CHECK(alarm.minute == at.minute && alarm.second == at.second && alarm.hour == at.hour);
+	// The periodic job's timer was stopped by the switch: one wake, the alarm
+	ranCount = 0;
+	CHECK(waitInt(700000) < 700000);
+	CHECK(rtc.readStatus(st));
+	CHECK_EQ(st & (MAX31329_STATUS_A1F | MAX31329_STATUS_TIF), MAX31329_STATUS_A1F);
+	CHECK_EQ(sched.service(), 1);
+	CHECK_EQ(ranCount, 1);
+	CHECK_EQ(nowMs() / 1000, (trimmed + 600000) / 1000);
+	rtc.clearTrim();
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testOrdering();
+	testRearmCost();
+	testSwitch();
+	testWakes();
+	return checkReport("test_scheduler");
+}
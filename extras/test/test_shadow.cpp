@@ -0,0 +1,131 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The config register shadow cache on the simulated device: bus reads of
+// the control calls with the cache off and on, hit and miss counts, and
+// invalidation after a failed write and after SWRST.
+
+#include <kode_MAX31329.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+// Ten read-modify-writes over four shadowed registers
+static void controlCalls() {
+	for (int i = 0; i < 5; ++i) {
+		CHECK(rtc.enableInterrupts(MAX31329_INT_A1IE));
+		CHECK(rtc.disableInterrupts(MAX31329_INT_A1IE));
+	}
+}
+
+static void testReadsSaved() {
+	// Off: every control call reads its register first
+	sim.resetCounters();
+	controlCalls();
+	CHECK_EQ(sim.counters().reads, 10);
+	CHECK_EQ(sim.counters().writes, 10);
+	CHECK_EQ(rtc.shadowStats().hits, 0);
+	CHECK_EQ(rtc.shadowStats().misses, 0);
+
+	// On: the resync is two burst reads, then only the writes
+	rtc.setShadowCache(true);
+	sim.resetCounters();
+	CHECK(rtc.shadowResync());
+	CHECK_EQ(sim.counters().reads, 2);
+	rtc.shadowStatsReset();
+	sim.resetCounters();
+	controlCalls();
+	CHECK_EQ(sim.counters().reads, 0);
+	CHECK_EQ(sim.counters().writes, 10);
+	CHECK_EQ(rtc.shadowStats().hits, 10);
+	CHECK_EQ(rtc.shadowStats().misses, 0);
+
+	// The other shadowed registers
+	sim.resetCounters();
+	CHECK(rtc.startRTC());
+	CHECK(rtc.timerPause());
+	CHECK(rtc.trickleEnable(0x5));
+	CHECK(rtc.clkoEnable(1));
+	CHECK_EQ(sim.counters().reads, 0);
+	CHECK_EQ(sim.peek(MAX31329_REG_TRICKLE) & 0x0F, 0x5);
+
+	// Invalidated: one miss refills the slot, then hits again
+	rtc.shadowInvalidate();
+	rtc.shadowStatsReset();
+	sim.resetCounters();
+	controlCalls();
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(rtc.shadowStats().misses, 1);
+	CHECK_EQ(rtc.shadowStats().hits, 9);
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), 0);
+}
+
+static void testFailedWrite() {
+	// A refused write leaves the register unknown: the next call re-reads it
+	CHECK(rtc.shadowResync());
+	sim.inject(MAX31329_SIM_FAULT_DATA_NACK);
+	CHECK(!rtc.enableInterrupts(MAX31329_INT_TIE));
+	rtc.shadowStatsReset();
+	sim.resetCounters();
+	CHECK(rtc.enableInterrupts(MAX31329_INT_A2IE));
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(rtc.shadowStats().misses, 1);
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), MAX31329_INT_A2IE);
+
+	// Only the failed register: CFG1 is still cached
+	sim.resetCounters();
+	CHECK(rtc.startRTC());
+	CHECK_EQ(sim.counters().reads, 0);
+}
+
+static void testReset() {
+	// SWRST, direct or committed, returns the registers to their defaults;
+	// the shadow must not answer with the values from before
+	CHECK(rtc.shadowResync());
+	CHECK(rtc.enableInterrupts(MAX31329_INT_A1IE));
+	CHECK(rtc.assertReset());
+	CHECK(rtc.releaseReset());
+	rtc.shadowStatsReset();
+	sim.resetCounters();
+	CHECK(rtc.enableInterrupts(MAX31329_INT_TIE));
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), MAX31329_INT_TIE);
+
+	CHECK(rtc.shadowResync());
+	MAX31329_Transaction tx;
+	tx.assertReset();
+	CHECK(rtc.commit(tx));
+	tx.clear();
+	tx.releaseReset();
+	CHECK(rtc.commit(tx));
+	sim.resetCounters();
+	CHECK(rtc.enableInterrupts(MAX31329_INT_A2IE));
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), MAX31329_INT_A2IE);
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testReadsSaved();
+	testFailedWrite();
+	testReset();
+	return checkReport("test_shadow");
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The driver's public API against the simulated device on the TwoWire
+// stand-in: BCD time and rollovers, alarm matching, the countdown timer,
+// clear-on-read STATUS, NVRAM, SWRST, transaction counts and bus faults.
+
+#include <kode_MAX31329.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static MAX31329_Sim sim;
+static MAX31329 rtc;
+
+static void advanceMs(int64_t ms) {
+	MAX31329_SimClock::advance(ms * 1000);
+}
+
+static void testPowerOn() {
+	uint8_t st = 0;
+	sim.powerOn();
+	CHECK(rtc.readStatus(st));
+	CHECK(st & MAX31329_STATUS_OSF);
+	CHECK(rtc.readStatus(st));
+	CHECK_EQ(st, 0);
+	CHECK_EQ(sim.peek(MAX31329_REG_CFG1), 0x0B);
+	CHECK_EQ(sim.peek(MAX31329_REG_TIMER_CONFIG), MAX31329_TMR_TRPT);
+	CHECK_EQ(sim.peek(MAX31329_REG_PWR_MGMT), 0x0C);
+}
+
+static void testTime() {
+	// Leap day, then the year and century rollovers
+	CHECK(rtc.writeTime(2024, 2, 28, 23, 59, 58));
+	advanceMs(3000);
+	int y, mo, d, h, mi, s, dow;
+	CHECK(rtc.readTime(y, mo, d, h, mi, s, dow));
+	CHECK(y == 2024 && mo == 2 && d == 29 && h == 0 && mi == 0 && s == 1);
+	CHECK_EQ(dow, 4); // Thursday
+	CHECK_EQ(sim.peek(MAX31329_REG_DAY), 5);
+	CHECK_EQ(sim.peek(MAX31329_REG_DATE), 0x29);
+
+	CHECK(rtc.writeEpoch(4107542399LL)); // 2100-02-28 23:59:59
+	advanceMs(1000);
+	CHECK(rtc.readTime(y, mo, d, h, mi, s, dow));
+	CHECK(y == 2100 && mo == 3 && d == 1 && h == 0 && mi == 0 && s == 0);
+	CHECK(sim.peek(MAX31329_REG_MONTH) & MAX31329_MONTH_CENTURY);
+	int64_t e = 0;
+	CHECK(rtc.readEpoch(e));
+	CHECK_EQ(e, 4107542400LL);
+
+	// Writing SECONDS restarts the divider chain: a full second to the edge
+	CHECK(rtc.writeEpoch(1735689600));
+	int64_t written = sim.epochUs();
+	CHECK_EQ(written % 1000000, 0);
+	advanceMs(999);
+	CHECK_EQ(sim.epoch(), 1735689600);
+	advanceMs(1);
+	CHECK_EQ(sim.epoch(), 1735689601);
+
+	// A stopped oscillator freezes the count and sets OSF
+	uint8_t st;
+	CHECK(rtc.readStatus(st));
+	CHECK(rtc.stopRTC());
+	int64_t frozen = sim.epoch();
+	advanceMs(5000);
+	CHECK_EQ(sim.epoch(), frozen);
+	CHECK(rtc.readStatus(st));
+	CHECK(st & MAX31329_STATUS_OSF);
+	CHECK(rtc.startRTC());
+	CHECK(rtc.readStatus(st)); // latched until read with the oscillator running
+	CHECK(rtc.readStatus(st));
+	CHECK(!(st & MAX31329_STATUS_OSF));
+
+	// Oscillator error: +100 ppm gains 8.64 s a day
+	CHECK(rtc.writeEpoch(1735689600));
+	sim.setPpm(100);
+	advanceMs(86400000);
+	CHECK_EQ(sim.epoch(), 1735689600 + 86400 + 8);
+	sim.setPpm(0);
+}
+
+static void testAlarms() {
+	uint8_t st;
+	CHECK(rtc.writeTime(2025, 3, 10, 12, 0, 0)); // Monday
+	CHECK(rtc.enableInterrupts(MAX31329_INT_A1IE | MAX31329_INT_A2IE));
+	CHECK(rtc.setAlarm1(MAX31329_Alarm1::atSecond(30)));
+	CHECK(rtc.readStatus(st));
+	CHECK(!sim.intAsserted());
+	advanceMs(29000);
+	CHECK(!sim.intAsserted());
+	advanceMs(1000);
+	CHECK(sim.intAsserted());
+	CHECK(rtc.readStatus(st));
+	CHECK(st & MAX31329_STATUS_A1F);
+	CHECK(!sim.intAsserted()); // cleared by the read
+	CHECK(rtc.readStatus(st));
+	CHECK(!(st & MAX31329_STATUS_A1F));
+
+	// Full match with day-of-week, and the year mask
+	CHECK(rtc.setAlarm1(MAX31329_Alarm1::onDay(2, 7, 30, 0))); // Tuesday 07:30:00
+	CHECK(rtc.writeTime(2025, 3, 11, 7, 29, 59));
+	CHECK(rtc.readStatus(st));
+	advanceMs(1000);
+	CHECK(rtc.readStatus(st));
+	CHECK(st & MAX31329_STATUS_A1F);
+	CHECK(rtc.setAlarm1(MAX31329_Alarm1::once(2026, 3, 11, 7, 30, 0)));
+	CHECK(rtc.writeTime(2025, 3, 11, 7, 29, 59));
+	CHECK(rtc.readStatus(st));
+	advanceMs(1000);
+	CHECK(rtc.readStatus(st));
+	CHECK(!(st & MAX31329_STATUS_A1F));
+
+	// Alarm2 has no seconds: it fires at :00 of the matching minute
+	CHECK(rtc.setAlarm1(MAX31329_Alarm1::once(2099, 1, 1, 0, 0, 0)));
+	CHECK(rtc.setAlarm2(MAX31329_Alarm2::atHour(8, 15)));
+	CHECK(rtc.writeTime(2025, 3, 11, 8, 14, 58));
+	CHECK(rtc.readStatus(st));
+	advanceMs(1000);
+	CHECK(rtc.readStatus(st));
+	CHECK(!(st & MAX31329_STATUS_A2F));
+	advanceMs(1000);
+	CHECK(rtc.readStatus(st));
+	CHECK(st & MAX31329_STATUS_A2F);
+
+	// Over a day, an every-minute Alarm2 fires once per minute read
+	CHECK(rtc.setAlarm2(MAX31329_Alarm2::everyMinute()));
+	int fired = 0;
+	for (int i = 0; i < 120; ++i) {
+		advanceMs(30000);
+		CHECK(rtc.readStatus(st));
+		if (st & MAX31329_STATUS_A2F) ++fired;
+	}
+	CHECK_EQ(fired, 60);
+	CHECK(rtc.disableInterrupts(MAX31329_INT_A1IE | MAX31329_INT_A2IE));
+}
+
+static void testTimer() {
+	static const uint16_t HZ[4] = {1024, 256, 64, 16};
+	uint8_t st, value;
+	for (uint8_t f = 0; f < 4; ++f) {
+		// 32 ticks, one shot
+		CHECK(rtc.timerConfigure(32, false, f));
+		CHECK(rtc.readStatus(st));
+		CHECK(rtc.timerStart());
+		int64_t periodUs = 32 * 1000000LL / HZ[f];
+		MAX31329_SimClock::advance(periodUs / 2);
+		CHECK(rtc.timerRead(value));
+		CHECK(value > 14 && value < 18);
+		CHECK(rtc.readStatus(st));
+		CHECK(!(st & MAX31329_STATUS_TIF));
+		MAX31329_SimClock::advance(periodUs / 2 + 1000000 / HZ[f]);
+		CHECK(rtc.readStatus(st));
+		CHECK(st & MAX31329_STATUS_TIF);
+		CHECK(rtc.timerRead(value));
+		CHECK_EQ(value, 0);
+		MAX31329_SimClock::advance(periodUs * 2);
+		CHECK(rtc.readStatus(st));
+		CHECK(!(st & MAX31329_STATUS_TIF)); // halted
+	}
+
+	// Repeat: reloads and keeps firing; pause holds the count
+	CHECK(rtc.timerConfigure(16, true, 3));
+	CHECK(rtc.timerStart());
+	int fired = 0;
+	for (int i = 0; i < 10; ++i) {
+		advanceMs(1000);
+		CHECK(rtc.readStatus(st));
+		if (st & MAX31329_STATUS_TIF) ++fired;
+	}
+	CHECK_EQ(fired, 10);
+	advanceMs(500);
+	CHECK(rtc.timerPause());
+	CHECK(rtc.timerRead(value));
+	advanceMs(3000);
+	uint8_t held;
+	CHECK(rtc.timerRead(held));
+	CHECK_EQ(held, value);
+	CHECK(rtc.timerContinue());
+	CHECK(rtc.timerStop());
+	CHECK(rtc.readStatus(st));
+}
+
+static void testRamAndRegisters() {
+	uint8_t in[64], out[64];
+	for (int i = 0; i < 64; ++i) in[i] = (uint8_t)(i * 7 + 3);
+	CHECK(rtc.writeRam(0, in, 64));
+	CHECK(rtc.readRam(0, out, 64));
+	CHECK(memcmp(in, out, 64) == 0);
+	CHECK(!rtc.writeRam(60, in, 8));
+	CHECK_EQ(sim.peek(MAX31329_REG_RAM_END), in[63]);
+
+	// STATUS and TIMER_COUNT are read-only
+	uint8_t v = 0xFF;
+	CHECK(rtc.writeBytes(MAX31329_REG_TIMER_COUNT, &v, 1));
+	CHECK_EQ(sim.peek(MAX31329_REG_TIMER_COUNT), 0);
+
+	// SWRST restores the register defaults and keeps the RAM
+	CHECK(rtc.enableInterrupts(MAX31329_INT_TIE));
+	CHECK(rtc.assertReset());
+	CHECK(rtc.releaseReset());
+	CHECK_EQ(sim.peek(MAX31329_REG_INT_EN), 0);
+	CHECK_EQ(sim.epoch(), 946684800);
+	CHECK(rtc.readRam(0, out, 64));
+	CHECK(memcmp(in, out, 64) == 0);
+}
+
+static void testCountersAndFaults() {
+	CHECK(rtc.writeEpoch(1735689600));
+	sim.resetCounters();
+	CHECK(rtc.readTime());
+	CHECK_EQ(sim.counters().reads, 1);
+	CHECK_EQ(sim.counters().bytesRead, 7);
+	CHECK(rtc.writeTime());
+	CHECK_EQ(sim.counters().writes, 1);
+	CHECK_EQ(sim.counters().bytesWritten, 7);
+
+	sim.inject(MAX31329_SIM_FAULT_ADDR_NACK);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_ADDR_NACK);
+	CHECK(rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_OK);
+
+	sim.inject(MAX31329_SIM_FAULT_SHORT_READ);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_SHORT_READ);
+
+	// Skip two transactions, then fail one
+	sim.inject(MAX31329_SIM_FAULT_DATA_NACK, 1, 2);
+	CHECK(rtc.readTime());
+	CHECK(rtc.readTime());
+	CHECK(!rtc.writeTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_DATA_NACK);
+	CHECK(rtc.writeTime());
+	CHECK_EQ(sim.counters().faults, 3);
+
+	// No device at the address
+	rtc.setAddress(0x69);
+	CHECK(!rtc.isConnected());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_ADDR_NACK);
+	rtc.setAddress(MAX31329_I2C_ADDRESS);
+	CHECK(rtc.isConnected());
+}
+
+int main() {
+	Wire.attach(sim);
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin());
+	testPowerOn();
+	testTime();
+	testAlarms();
+	testTimer();
+	testRamAndRegisters();
+	testCountersAndFaults();
+	return checkReport("test_sim");
+}
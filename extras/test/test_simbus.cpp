@@ -0,0 +1,75 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The driver built against a stub bus policy (MAX31329_SimBus, selected with
+// KODE_MAX31329_BUS) with statistics on: the driver's own transaction counts
+// agree with the device's, and policy errors reach lastError().
+
+#include <kode_MAX31329.h>
+
+#include "MAX31329_sim.h"
+#include "check.h"
+
+static_assert(sizeof(MAX31329_Bus) == sizeof(MAX31329_SimBus), "stub bus not selected");
+
+int main() {
+	MAX31329_Sim sim;
+	MAX31329 rtc;
+	rtc.setMicrosSource(MAX31329_SimClock::now);
+	CHECK(rtc.begin(MAX31329_SimBus(sim)));
+
+	CHECK(rtc.writeTime(2025, 6, 1, 10, 0, 0));
+	MAX31329_SimClock::advance(2000000);
+	CHECK(rtc.readTime());
+	CHECK_EQ(rtc.t.second, 2);
+
+	rtc.statsReset();
+	sim.resetCounters();
+	uint8_t st;
+	MAX31329_Snapshot snap;
+	for (int i = 0; i < 10; ++i) {
+		CHECK(rtc.readTime());
+		CHECK(rtc.readStatus(st));
+		CHECK(rtc.setAlarm1(MAX31329_Alarm1::atSecond((uint8_t)i)));
+		CHECK(rtc.snapshot(snap));
+	}
+	MAX31329_Stats stats;
+	rtc.statsSnapshot(stats);
+	uint32_t txns = 0;
+	for (const MAX31329_OpStats &op : stats.ops) txns += op.transactions;
+	CHECK_EQ(txns, sim.counters().reads + sim.counters().writes);
+	CHECK_EQ(stats.ops[MAX31329_OP_READ_TIME].transactions, 10);
+	CHECK_EQ(stats.ops[MAX31329_OP_SET_ALARM].transactions, 10);
+	CHECK_EQ(stats.ops[MAX31329_OP_SNAPSHOT].transactions, 10);
+
+	sim.inject(MAX31329_SIM_FAULT_ARBITRATION);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_BUS);
+	sim.inject(MAX31329_SIM_FAULT_TIMEOUT);
+	CHECK(!rtc.readTime());
+	CHECK_EQ(rtc.lastError(), MAX31329_ERR_TIMEOUT);
+	rtc.statsSnapshot(stats);
+	CHECK_EQ(stats.ops[MAX31329_OP_READ_TIME].failures, 2);
+
+	// The policy's recover() clocks a stuck device free
+	sim.holdSda(5);
+	CHECK(!rtc.readTime());
+	CHECK(rtc.recoverBus());
+	CHECK(!sim.sdaHeld());
+	CHECK(rtc.readTime());
+
+	return checkReport("test_simbus");
+}
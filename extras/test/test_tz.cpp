@@ -0,0 +1,177 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// MAX31329_TimeZone: the POSIX TZ parser, the transition table of a northern
+// and a southern zone against hand-written rules at every hour of 2000-2199,
+// the toUtc() round trip, and the spring-forward gap and fall-back overlap.
+
+#include <MAX31329_tz.h>
+
+#include "check.h"
+
+static const int64_t FROM = 946684800;  // 2000-01-01 00:00:00
+static const int64_t TO = 7258118400;   // 2200-01-01 00:00:00
+
+static int64_t utc(int y, int mo, int d, int h, int mi = 0) {
+	MAX31329_Time t;
+	t.year = y;
+	t.month = mo;
+	t.day = d;
+	t.hour = h;
+	t.minute = mi;
+	return MAX31329::timeToEpoch(t);
+}
+
+// Day of the month of the n-th (0: last) Sunday
+static int sunday(int y, int mo, int n) {
+	MAX31329_Time t;
+	if (n == 0) {
+		MAX31329::epochToTime(utc(y, mo, MAX31329::daysInMonth(y, mo), 0), t);
+		return t.day - t.dayOfWeek;
+	}
+	MAX31329::epochToTime(utc(y, mo, 1, 0), t);
+	return 1 + (7 - t.dayOfWeek) % 7 + (n - 1) * 7;
+}
+
+// EU: last Sunday of March 01:00 UTC to last Sunday of October 01:00 UTC
+static bool cetDst(int64_t e, int y) {
+	return e >= utc(y, 3, sunday(y, 3, 0), 1) && e < utc(y, 10, sunday(y, 10, 0), 1);
+}
+
+// Sydney: standard time from the first Sunday of April 03:00 AEDT to the
+// first Sunday of October 02:00 AEST
+static bool aestDst(int64_t e, int y) {
+	return !(e >= utc(y, 4, sunday(y, 4, 1), 3) - 11 * 3600 &&
+		e < utc(y, 10, sunday(y, 10, 1), 2) - 10 * 3600);
+}
+
+static void scan(const char *rules, int32_t stdOff, int32_t dstOff, bool (*dst)(int64_t, int)) {
+	MAX31329_TimeZone tz;
+	CHECK(tz.setRules(rules));
+	CHECK(tz.hasDst());
+	CHECK_EQ(tz.transitions(), MAX31329_TZ_MAX_TRANSITIONS);
+
+	uint32_t wrong = 0, trip = 0, dstHours = 0;
+	for (int64_t e = FROM; e < TO; e += 3600) {
+		MAX31329_Time t;
+		MAX31329::epochToTime(e, t);
+		// Transitions fall on the hour: check both sides of each boundary
+		for (int64_t s = (e == FROM ? e : e - 1); s <= e; ++s) {
+			bool ref = dst(s, t.year);
+			bool isDst;
+			if (tz.offsetAt(s, &isDst) != (ref ? dstOff : stdOff) || isDst != ref) wrong++;
+		}
+		bool isDst;
+		int64_t local = tz.toLocal(e, &isDst), back;
+		if (!tz.toUtc(local, back, isDst ? 1 : 0) || back != e) trip++;
+		if (isDst) dstHours++;
+	}
+	if (wrong || trip) printf("%s: %u wrong, %u round trips failed\n", rules, wrong, trip);
+	CHECK_EQ(wrong, 0);
+	CHECK_EQ(trip, 0);
+	CHECK(dstHours > 0);
+}
+
+static void testParse() {
+	MAX31329_TimeZone tz;
+	// No DST: a fixed offset, no table
+	CHECK(tz.setRules("JST-9"));
+	CHECK(!tz.hasDst());
+	CHECK_EQ(tz.transitions(), 0);
+	bool isDst = true;
+	CHECK_EQ(tz.offsetAt(utc(2025, 7, 1, 0), &isDst), 9 * 3600);
+	CHECK(!isDst);
+	int64_t back;
+	CHECK(tz.toUtc(utc(2025, 7, 1, 9), back));
+	CHECK_EQ(back, utc(2025, 7, 1, 0));
+	CHECK(tz.setRules("<+0530>-5:30"));
+	CHECK_EQ(tz.offsetAt(utc(2025, 1, 1, 0)), 5 * 3600 + 1800);
+	CHECK(tz.setRules("HST10"));
+	CHECK_EQ(tz.offsetAt(utc(2025, 1, 1, 0)), -10 * 3600);
+
+	// Julian and zero-based day rules
+	CHECK(tz.setRules("XST5XDT,J60,300/1"));
+	CHECK(tz.hasDst());
+	CHECK(tz.setRules("XST5XDT4,59/0,J300"));
+
+	// Malformed strings fail and leave the zone at UTC
+	static const char *const BAD[] = {
+		"", "CE-1", "CET", "CET-168", "CET-1:60", "<+05-5", "CET-1CEST,M3.5.0",
+		"CET-1CEST,M13.5.0,M10.5.0/3", "CET-1CEST,M3.6.0,M10.5.0/3", "CET-1CEST,M3.5.7,M10.5.0/3",
+		"CET-1CEST,M3.5,M10.5.0/3", "CET-1CEST,J0,J100", "CET-1CEST,366,J100",
+		"CET-1CEST,M3.5.0,M10.5.0/3x", "CET-1CEST;M3.5.0,M10.5.0", "CET-1CEST,M3.5.0,M10.5.0/",
+	};
+	for (size_t i = 0; i < sizeof(BAD) / sizeof(BAD[0]); ++i) {
+		CHECK(tz.setRules("CET-1CEST,M3.5.0,M10.5.0/3"));
+		if (tz.setRules(BAD[i])) printf("parsed: \"%s\"\n", BAD[i]);
+		CHECK(!tz.hasDst());
+		CHECK_EQ(tz.offsetAt(utc(2025, 7, 1, 0)), 0);
+	}
+	CHECK(!tz.setRules(nullptr));
+}
+
+static void testGapOverlap() {
+	MAX31329_TimeZone tz;
+	CHECK(tz.setRules("CET-1CEST,M3.5.0,M10.5.0/3"));
+
+	// 2025-03-30: 02:00 CET jumps to 03:00 CEST (01:00 UTC)
+	int64_t utcEpoch;
+	CHECK(tz.toUtc(utc(2025, 3, 30, 1, 59), utcEpoch));
+	CHECK_EQ(utcEpoch, utc(2025, 3, 30, 0, 59));
+	CHECK(!tz.toUtc(utc(2025, 3, 30, 2, 30), utcEpoch));
+	CHECK_EQ(utcEpoch, utc(2025, 3, 30, 1, 30)); // shifted: 03:30 CEST
+	CHECK(tz.toUtc(utc(2025, 3, 30, 3, 0), utcEpoch));
+	CHECK_EQ(utcEpoch, utc(2025, 3, 30, 1, 0));
+	CHECK_EQ(tz.nextDaily(utc(2025, 3, 29, 12), 2, 30, 0), utc(2025, 3, 30, 1, 30));
+
+	// 2025-10-26: 03:00 CEST falls back to 02:00 CET (01:00 UTC); 02:30 twice
+	CHECK(tz.toUtc(utc(2025, 10, 26, 2, 30), utcEpoch));
+	CHECK_EQ(utcEpoch, utc(2025, 10, 26, 0, 30));
+	CHECK(tz.toUtc(utc(2025, 10, 26, 2, 30), utcEpoch, 1));
+	CHECK_EQ(utcEpoch, utc(2025, 10, 26, 0, 30));
+	CHECK(tz.toUtc(utc(2025, 10, 26, 2, 30), utcEpoch, 0));
+	CHECK_EQ(utcEpoch, utc(2025, 10, 26, 1, 30));
+	CHECK(tz.toUtc(utc(2025, 10, 26, 3, 0), utcEpoch, 1));
+	CHECK_EQ(utcEpoch, utc(2025, 10, 26, 2, 0));
+
+	struct tm tm;
+	tz.toLocal(utc(2025, 10, 26, 0, 30), tm);
+	CHECK_EQ(tm.tm_hour, 2);
+	CHECK_EQ(tm.tm_isdst, 1);
+	tz.toLocal(utc(2025, 10, 26, 1, 30), tm);
+	CHECK_EQ(tm.tm_hour, 2);
+	CHECK_EQ(tm.tm_isdst, 0);
+
+	// Southern: 2025-04-06 03:00 AEDT falls back, 2025-10-05 02:00 AEST jumps
+	CHECK(tz.setRules("AEST-10AEDT,M10.1.0,M4.1.0/3"));
+	bool isDst;
+	CHECK_EQ(tz.offsetAt(utc(2025, 1, 15, 12), &isDst), 11 * 3600);
+	CHECK(isDst);
+	CHECK(tz.toUtc(utc(2025, 4, 6, 2, 30), utcEpoch, 0));
+	CHECK_EQ(utcEpoch, utc(2025, 4, 5, 16, 30));
+	CHECK(tz.toUtc(utc(2025, 4, 6, 2, 30), utcEpoch));
+	CHECK_EQ(utcEpoch, utc(2025, 4, 5, 15, 30));
+	CHECK(!tz.toUtc(utc(2025, 10, 5, 2, 30), utcEpoch));
+	CHECK_EQ(utcEpoch, utc(2025, 10, 4, 16, 30));
+}
+
+int main() {
+	testParse();
+	scan("CET-1CEST,M3.5.0,M10.5.0/3", 3600, 7200, cetDst);
+	scan("AEST-10AEDT,M10.1.0,M4.1.0/3", 36000, 39600, aestDst);
+	testGapOverlap();
+	return checkReport("test_tz");
+}
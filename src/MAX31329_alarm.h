@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_ALARM_H
+#define KODE_MAX31329_ALARM_H
+
+#include <stdint.h>
+
+#include "MAX31329_registers.h"
+
+// Alarm specs are literal types: built with the constexpr factories they
+// encode to register bytes at compile time, e.g.
+//   constexpr MAX31329_Alarm1 a = MAX31329_Alarm1::atHour(7, 30, 0);
+//   static_assert(a.valid(), "bad alarm");
+// dayOfWeek is 0..6 (0=Sunday) like MAX31329_Time; years are full years.
+
+constexpr uint8_t max31329Bcd(uint8_t v) { return (uint8_t)(((v / 10) << 4) | (v % 10)); }
+
+// Alarm1 match modes (datasheet Table 3)
+enum MAX31329_Alarm1Mode : uint8_t {
+	MAX31329_ALARM1_EVERY_SECOND = 0,
+	MAX31329_ALARM1_MATCH_SECOND,   // once a minute
+	MAX31329_ALARM1_MATCH_MINUTE,   // minutes and seconds, once an hour
+	MAX31329_ALARM1_MATCH_HOUR,     // hours, minutes and seconds, once a day
+	MAX31329_ALARM1_MATCH_DATE,     // date of month + time, once a month
+	MAX31329_ALARM1_MATCH_DAY,      // day of week + time, once a week
+	MAX31329_ALARM1_MATCH_MONTH,    // month + date + time, once a year
+	MAX31329_ALARM1_MATCH_YEAR      // full date and time, once
+};
+
+// Alarm2 match modes (datasheet Table 4), always at 00 seconds
+enum MAX31329_Alarm2Mode : uint8_t {
+	MAX31329_ALARM2_EVERY_MINUTE = 0,
+	MAX31329_ALARM2_MATCH_MINUTE,   // once an hour
+	MAX31329_ALARM2_MATCH_HOUR,     // hours and minutes, once a day
+	MAX31329_ALARM2_MATCH_DATE,     // date of month + time, once a month
+	MAX31329_ALARM2_MATCH_DAY       // day of week + time, once a week
+};
+
+struct MAX31329_Alarm1 {
+	MAX31329_Alarm1Mode mode;
+	uint8_t second;
+	uint8_t minute;
+	uint8_t hour;
+	uint8_t dayOrDate; // day of week 0..6 for MATCH_DAY, else date 1..31
+	uint8_t month;     // 1..12
+	uint16_t year;     // 2000..2199 (the register holds year % 100)
+
+	static constexpr MAX31329_Alarm1 everySecond() { return MAX31329_Alarm1{MAX31329_ALARM1_EVERY_SECOND, 0, 0, 0, 1, 1, 2000}; }
+	static constexpr MAX31329_Alarm1 atSecond(uint8_t s) { return MAX31329_Alarm1{MAX31329_ALARM1_MATCH_SECOND, s, 0, 0, 1, 1, 2000}; }
+	static constexpr MAX31329_Alarm1 atMinute(uint8_t m, uint8_t s) { return MAX31329_Alarm1{MAX31329_ALARM1_MATCH_MINUTE, s, m, 0, 1, 1, 2000}; }
+	static constexpr MAX31329_Alarm1 atHour(uint8_t h, uint8_t m, uint8_t s) { return MAX31329_Alarm1{MAX31329_ALARM1_MATCH_HOUR, s, m, h, 1, 1, 2000}; }
+	static constexpr MAX31329_Alarm1 onDate(uint8_t date, uint8_t h, uint8_t m, uint8_t s) { return MAX31329_Alarm1{MAX31329_ALARM1_MATCH_DATE, s, m, h, date, 1, 2000}; }
+	static constexpr MAX31329_Alarm1 onDay(uint8_t dayOfWeek, uint8_t h, uint8_t m, uint8_t s) { return MAX31329_Alarm1{MAX31329_ALARM1_MATCH_DAY, s, m, h, dayOfWeek, 1, 2000}; }
+	static constexpr MAX31329_Alarm1 onMonth(uint8_t month, uint8_t date, uint8_t h, uint8_t m, uint8_t s) { return MAX31329_Alarm1{MAX31329_ALARM1_MATCH_MONTH, s, m, h, date, month, 2000}; }
+	static constexpr MAX31329_Alarm1 once(uint16_t year, uint8_t month, uint8_t date, uint8_t h, uint8_t m, uint8_t s) { return MAX31329_Alarm1{MAX31329_ALARM1_MATCH_YEAR, s, m, h, date, month, year}; }
+
+	constexpr bool valid() const {
+		return mode <= MAX31329_ALARM1_MATCH_YEAR && second < 60 && minute < 60 && hour < 24 &&
+			(mode == MAX31329_ALARM1_MATCH_DAY ? dayOrDate < 7 : (dayOrDate >= 1 && dayOrDate <= 31)) &&
+			month >= 1 && month <= 12 && year >= 2000 && year <= 2199;
+	}
+
+	// Mask bit An (1..6) is set when that field is ignored
+	constexpr bool masked(uint8_t n) const {
+		return n == 6 ? mode != MAX31329_ALARM1_MATCH_YEAR
+			: n == 5 ? mode < MAX31329_ALARM1_MATCH_MONTH
+			: n == 4 ? mode < MAX31329_ALARM1_MATCH_DATE
+			: mode < n;
+	}
+
+	// Register byte i of ALM1_SEC..ALM1_YEAR (0x0D..0x12)
+	constexpr uint8_t reg(uint8_t i) const {
+		return i == 0 ? (uint8_t)(max31329Bcd(second) | (masked(1) ? MAX31329_ALM_MASK : 0))
+			: i == 1 ? (uint8_t)(max31329Bcd(minute) | (masked(2) ? MAX31329_ALM_MASK : 0))
+			: i == 2 ? (uint8_t)(max31329Bcd(hour) | (masked(3) ? MAX31329_ALM_MASK : 0))
+			: i == 3 ? (uint8_t)((mode == MAX31329_ALARM1_MATCH_DAY ? (MAX31329_ALM_DY_DT | (dayOrDate + 1)) : max31329Bcd(dayOrDate)) |
+				(masked(4) ? MAX31329_ALM_MASK : 0))
+			: i == 4 ? (uint8_t)(max31329Bcd(month) | (masked(5) ? MAX31329_ALM_MASK : 0) | (masked(6) ? MAX31329_ALM1_MON_A1M6 : 0))
+			: max31329Bcd((uint8_t)(year % 100));
+	}
+};
+
+struct MAX31329_Alarm2 {
+	MAX31329_Alarm2Mode mode;
+	uint8_t minute;
+	uint8_t hour;
+	uint8_t dayOrDate; // day of week 0..6 for MATCH_DAY, else date 1..31
+
+	static constexpr MAX31329_Alarm2 everyMinute() { return MAX31329_Alarm2{MAX31329_ALARM2_EVERY_MINUTE, 0, 0, 1}; }
+	static constexpr MAX31329_Alarm2 atMinute(uint8_t m) { return MAX31329_Alarm2{MAX31329_ALARM2_MATCH_MINUTE, m, 0, 1}; }
+	static constexpr MAX31329_Alarm2 atHour(uint8_t h, uint8_t m) { return MAX31329_Alarm2{MAX31329_ALARM2_MATCH_HOUR, m, h, 1}; }
+	static constexpr MAX31329_Alarm2 onDate(uint8_t date, uint8_t h, uint8_t m) { return MAX31329_Alarm2{MAX31329_ALARM2_MATCH_DATE, m, h, date}; }
+	static constexpr MAX31329_Alarm2 onDay(uint8_t dayOfWeek, uint8_t h, uint8_t m) { return MAX31329_Alarm2{MAX31329_ALARM2_MATCH_DAY, m, h, dayOfWeek}; }
+
+	constexpr bool valid() const {
+		return mode <= MAX31329_ALARM2_MATCH_DAY && minute < 60 && hour < 24 &&
+			(mode == MAX31329_ALARM2_MATCH_DAY ? dayOrDate < 7 : (dayOrDate >= 1 && dayOrDate <= 31));
+	}
+
+	// Mask bit A2Mn (2..4) is set when that field is ignored
+	constexpr bool masked(uint8_t n) const {
+		return n == 4 ? mode < MAX31329_ALARM2_MATCH_DATE : mode < n - 1;
+	}
+
+	// Register byte i of ALM2_MIN..ALM2_DAY_DATE (0x13..0x15)
+	constexpr uint8_t reg(uint8_t i) const {
+		return i == 0 ? (uint8_t)(max31329Bcd(minute) | (masked(2) ? MAX31329_ALM_MASK : 0))
+			: i == 1 ? (uint8_t)(max31329Bcd(hour) | (masked(3) ? MAX31329_ALM_MASK : 0))
+			: (uint8_t)((mode == MAX31329_ALARM2_MATCH_DAY ? (MAX31329_ALM_DY_DT | (dayOrDate + 1)) : max31329Bcd(dayOrDate)) |
+				(masked(4) ? MAX31329_ALM_MASK : 0));
+	}
+};
+
+#endif // KODE_MAX31329_ALARM_H
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_BUS_H
+#define KODE_MAX31329_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <string.h>
+
+#include "MAX31329_registers.h"
+
+// Bus policies. The driver talks to the chip only through MAX31329_Bus,
+// which is selected at compile time, so there is no virtual dispatch on the
+// transfer path. A policy is a default-constructible type providing:
+//
+//   bool attached() const;                                  // ready for transfers
+//   bool read(uint8_t reg, uint8_t *buf, size_t len);       // write reg, repeated START, read
+//   bool write(uint8_t reg, const uint8_t *buf, size_t len);
+//   MAX31329_Error error() const;                           // why the last transfer failed
+//   void setTimeout(uint16_t ms);                           // per-transfer bus timeout
+//   bool recover();                                         // free a stuck bus
+//
+// Selection (the MAX31329_Bus typedef in kode_MAX31329.h), in order of precedence:
+//   -DKODE_MAX31329_BUS=MyBus   user-supplied policy (e.g. a host mock), declared
+//                               before kode_MAX31329.h; may derive from MAX31329_BusBase
+//   -DKODE_MAX31329_IDF_BUS=1   ESP-IDF i2c_master driver, no Wire buffers
+//   default                     Arduino TwoWire
+
+// Largest single write (register byte excluded): a full NVRAM window
+#define MAX31329_BUS_MAX_WRITE 64
+
+// Per-transfer timeout assumed when none is set (the ESP32 Wire default)
+#ifndef MAX31329_BUS_DEFAULT_TIMEOUT_MS
+#define MAX31329_BUS_DEFAULT_TIMEOUT_MS 50
+#endif
+
+// Upper bound of one recover() sequence, Wire restart included
+#ifndef MAX31329_BUS_RECOVERY_US
+#define MAX31329_BUS_RECOVERY_US 500
+#endif
+
+// Half period of the recovery clock (~100 kHz)
+#ifndef MAX31329_BUS_RECOVERY_HALF_US
+#define MAX31329_BUS_RECOVERY_HALF_US 5
+#endif
+
+// Bus and driver error codes (MAX31329::lastError())
+enum MAX31329_Error : uint8_t {
+	MAX31329_OK = 0,
+	MAX31329_ERR_NOT_ATTACHED,  // begin() not called
+	MAX31329_ERR_LENGTH,        // transfer larger than the bus can carry
+	MAX31329_ERR_ADDR_NACK,     // no device answered at the address
+	MAX31329_ERR_DATA_NACK,     // device refused a data byte
+	MAX31329_ERR_TIMEOUT,       // bus timeout (SCL or SDA held low)
+	MAX31329_ERR_SHORT_READ,    // fewer bytes than requested
+	MAX31329_ERR_BUS,           // other bus error (arbitration, driver)
+	MAX31329_ERR_DEADLINE       // retries stopped by the call deadline
+};
+
+// Defaults for the optional part of the contract: a policy that derives
+// from this only needs attached(), read() and write(). Failures then
+// report MAX31329_ERR_BUS, and timeouts and recovery are unsupported.
+struct MAX31329_BusBase {
+	MAX31329_Error error() const { return MAX31329_ERR_BUS; }
+	void setTimeout(uint16_t ms) { (void)ms; }
+	bool recover() { return false; }
+};
+
+struct MAX31329_WireBus {
+	TwoWire *wire = nullptr;
+	uint8_t address = MAX31329_I2C_ADDRESS;
+	// Pins and clock for recover(); -1 falls back to the board's SDA/SCL
+	int sda = -1;
+	int scl = -1;
+	uint32_t frequency = 400000U;
+	uint16_t timeoutMs = 0; // 0 keeps the Wire default
+	MAX31329_Error err = MAX31329_OK;
+
+	MAX31329_WireBus() {}
+	explicit MAX31329_WireBus(TwoWire &w, uint8_t addr = MAX31329_I2C_ADDRESS)
+		: wire(&w), address(addr) {}
+
+	bool attached() const { return wire != nullptr; }
+	MAX31329_Error error() const { return err; }
+
+	// endTransmission(): 1 too long, 2 address NACK, 3 data NACK, 5 timeout
+	static MAX31329_Error fromWire(uint8_t code) {
+		switch (code) {
+		case 0: return MAX31329_OK;
+		case 1: return MAX31329_ERR_LENGTH;
+		case 2: return MAX31329_ERR_ADDR_NACK;
+		case 3: return MAX31329_ERR_DATA_NACK;
+		case 5: return MAX31329_ERR_TIMEOUT;
+		default: return MAX31329_ERR_BUS;
+		}
+	}
+
+	bool read(uint8_t reg, uint8_t *buffer, size_t length) {
+		wire->beginTransmission(address);
+		wire->write(reg);
+		if ((err = fromWire(wire->endTransmission(false))) != MAX31329_OK) return false;
+		if (wire->requestFrom((int)address, (int)length, (int)true) != (int)length) {
+			err = MAX31329_ERR_SHORT_READ;
+			return false;
+		}
+		for (size_t i = 0; i < length; ++i) buffer[i] = (uint8_t)wire->read();
+		return true;
+	}
+
+	bool write(uint8_t reg, const uint8_t *buffer, size_t length) {
+		wire->beginTransmission(address);
+		wire->write(reg);
+		wire->write(buffer, length);
+		return (err = fromWire(wire->endTransmission())) == MAX31329_OK;
+	}
+
+	void setTimeout(uint16_t ms) {
+		timeoutMs = ms;
+		if (wire && ms) wire->setTimeOut(ms);
+	}
+
+	// A slave holding SDA low mid-byte is released by clocking SCL until it
+	// lets go (at most 9 clocks), then issuing a STOP. Wire is restarted after.
+	bool recover() {
+		int d = sda, c = scl;
+#if defined(SDA) && defined(SCL)
+		if (d < 0 || c < 0) {
+			d = SDA;
+			c = SCL;
+		}
+#endif
+		if (!wire || d < 0 || c < 0) return false;
+		wire->end();
+		pinMode(d, INPUT_PULLUP);
+		pinMode(c, OUTPUT_OPEN_DRAIN);
+		digitalWrite(c, HIGH);
+		for (uint8_t i = 0; i < 9 && digitalRead(d) == LOW; ++i) {
+			digitalWrite(c, LOW);
+			delayMicroseconds(MAX31329_BUS_RECOVERY_HALF_US);
+			digitalWrite(c, HIGH);
+			delayMicroseconds(MAX31329_BUS_RECOVERY_HALF_US);
+		}
+		// STOP: SDA rises while SCL is high
+		pinMode(d, OUTPUT_OPEN_DRAIN);
+		digitalWrite(c, LOW);
+		digitalWrite(d, LOW);
+		delayMicroseconds(MAX31329_BUS_RECOVERY_HALF_US);
+		digitalWrite(c, HIGH);
+		delayMicroseconds(MAX31329_BUS_RECOVERY_HALF_US);
+		digitalWrite(d, HIGH);
+		delayMicroseconds(MAX31329_BUS_RECOVERY_HALF_US);
+		bool released = digitalRead(d) == HIGH;
+		wire->begin(d, c, frequency);
+		if (timeoutMs) wire->setTimeOut(timeoutMs);
+		return released;
+	}
+};
+
+#if !defined(KODE_MAX31329_BUS) && defined(KODE_MAX31329_IDF_BUS) && KODE_MAX31329_IDF_BUS
+#include <driver/i2c_master.h>
+
+// Direct ESP-IDF i2c_master backend. The device handle is created by the
+// caller with i2c_master_bus_add_device(), which also fixes the address and
+// SCL speed. Reads land straight in the caller's buffer.
+struct MAX31329_IdfBus {
+	i2c_master_dev_handle_t dev = nullptr;
+	i2c_master_bus_handle_t busHandle = nullptr; // optional, for recover()
+	int timeoutMs = 50;
+	MAX31329_Error err = MAX31329_OK;
+
+	MAX31329_IdfBus() {}
+	explicit MAX31329_IdfBus(i2c_master_dev_handle_t d, int timeout = 50,
+		i2c_master_bus_handle_t b = nullptr)
+		: dev(d), busHandle(b), timeoutMs(timeout) {}
+
+	bool attached() const { return dev != nullptr; }
+	MAX31329_Error error() const { return err; }
+
+	static MAX31329_Error fromIdf(esp_err_t e) {
+		switch (e) {
+		case ESP_OK: return MAX31329_OK;
+		case ESP_ERR_TIMEOUT: return MAX31329_ERR_TIMEOUT;
+		case ESP_ERR_NOT_FOUND: return MAX31329_ERR_ADDR_NACK;
+		case ESP_ERR_INVALID_SIZE: return MAX31329_ERR_LENGTH;
+		default: return MAX31329_ERR_BUS;
+		}
+	}
+
+	bool read(uint8_t reg, uint8_t *buffer, size_t length) {
+		err = fromIdf(i2c_master_transmit_receive(dev, &reg, 1, buffer, length, timeoutMs));
+		return err == MAX31329_OK;
+	}
+
+	bool write(uint8_t reg, const uint8_t *buffer, size_t length) {
+		// The register byte must lead the same transfer
+		if (length > MAX31329_BUS_MAX_WRITE) {
+			err = MAX31329_ERR_LENGTH;
+			return false;
+		}
+		uint8_t frame[1 + MAX31329_BUS_MAX_WRITE];
+		frame[0] = reg;
+		memcpy(frame + 1, buffer, length);
+		err = fromIdf(i2c_master_transmit(dev, frame, length + 1, timeoutMs));
+		return err == MAX31329_OK;
+	}
+
+	void setTimeout(uint16_t ms) { timeoutMs = ms; }
+
+	// The driver clocks SCL and issues the STOP itself
+	bool recover() { return busHandle && i2c_master_bus_reset(busHandle) == ESP_OK; }
+};
+#endif
+
+#endif // KODE_MAX31329_BUS_H
@@ -0,0 +1,305 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_cron.h"
+
+#include <ctype.h>
+#include <string.h>
+
+static const char *const CRON_MONTHS = "JANFEBMARAPRMAYJUNJULAUGSEPOCTNOVDEC";
+static const char *const CRON_DAYS = "SUNMONTUEWEDTHUFRISAT";
+
+static uint8_t cronCtz(uint64_t v) {
+	return (uint8_t)__builtin_ctzll(v);
+}
+
+static uint8_t cronCount(uint64_t v) {
+	return (uint8_t)__builtin_popcountll(v);
+}
+
+// Bits at index >= n
+static uint64_t cronFrom(uint8_t n) {
+	return n >= 64 ? 0 : ~0ULL << n;
+}
+
+// Number or three-letter name; names index from base (0 for days, 1 for months)
+static const char *cronValue(const char *p, const char *names, uint8_t base, int &v) {
+	if (isdigit((unsigned char)*p)) {
+		v = 0;
+		while (isdigit((unsigned char)*p)) v = v * 10 + (*p++ - '0');
+		return p;
+	}
+	if (!names || !isalpha((unsigned char)p[0]) || !isalpha((unsigned char)p[1]) ||
+		!isalpha((unsigned char)p[2])) {
+		return nullptr;
+	}
+	char n[3] = {(char)toupper((unsigned char)p[0]), (char)toupper((unsigned char)p[1]),
+		(char)toupper((unsigned char)p[2])};
+	for (uint8_t i = 0; names[i * 3]; ++i) {
+		if (!memcmp(n, &names[i * 3], 3)) {
+			v = i + base;
+			return p + 3;
+		}
+	}
+	return nullptr;
+}
+
+// One field: comma-separated *, a, a-b, each optionally /step
+static const char *cronField(const char *p, uint8_t lo, uint8_t hi, const char *names,
+	uint64_t &bits, bool &star) {
+	bits = 0;
+	star = (*p == '*');
+	for (;;) {
+		int a, b, step = 1;
+		if (*p == '*') {
+			a = lo;
+			b = hi;
+			++p;
+		} else {
+			if (!(p = cronValue(p, names, lo, a))) return nullptr;
+			b = a;
+			if (*p == '-') {
+				if (!(p = cronValue(p + 1, names, lo, b))) return nullptr;
+			}
+		}
+		if (*p == '/') {
+			if (!(p = cronValue(p + 1, nullptr, 0, step)) || step < 1) return nullptr;
+			if (a == b) b = hi; // "a/n" runs to the end of the range
+		}
+		if (a < lo || b > hi || a > b) return nullptr;
+		for (int v = a; v <= b; v += step) bits |= 1ULL << v;
+		if (*p != ',') break;
+		++p;
+	}
+	return (*p == '\0' || *p == ' ' || *p == '\t') ? p : nullptr;
+}
+
+MAX31329_Cron::MAX31329_Cron()
+	: minutes(0), hours(0), doms(0), months(0), dows(0), domStar(true), dowStar(true), ok(false),
+	planExact(false), planAlarm(2), oneShot(false),
+	a1(MAX31329_Alarm1::everySecond()), a2(MAX31329_Alarm2::everyMinute()) {}
+
+bool MAX31329_Cron::parse(const char *expr) {
+	static const struct { const char *name; const char *expr; } macros[] = {
+		{"@yearly", "0 0 1 1 *"}, {"@annually", "0 0 1 1 *"}, {"@monthly", "0 0 1 * *"},
+		{"@weekly", "0 0 * * 0"}, {"@daily", "0 0 * * *"}, {"@midnight", "0 0 * * *"},
+		{"@hourly", "0 * * * *"},
+	};
+	ok = false;
+	if (!expr) return false;
+	while (*expr == ' ' || *expr == '\t') ++expr;
+	if (*expr == '@') {
+		for (size_t i = 0; i < sizeof(macros) / sizeof(macros[0]); ++i) {
+			if (!strcmp(expr, macros[i].name)) return parse(macros[i].expr);
+		}
+		return false;
+	}
+	static const uint8_t lo[5] = {0, 0, 1, 1, 0};
+	static const uint8_t hi[5] = {59, 23, 31, 12, 7};
+	const char *names[5] = {nullptr, nullptr, nullptr, CRON_MONTHS, CRON_DAYS};
+	uint64_t bits[5];
+	bool star[5];
+	const char *p = expr;
+	for (uint8_t f = 0; f < 5; ++f) {
+		while (*p == ' ' || *p == '\t') ++p;
+		if (!(p = cronField(p, lo[f], hi[f], names[f], bits[f], star[f]))) return false;
+	}
+	while (*p == ' ' || *p == '\t') ++p;
+	if (*p) return false;
+
+	minutes = bits[0];
+	hours = (uint32_t)bits[1];
+	doms = (uint32_t)bits[2];
+	months = (uint16_t)bits[3];
+	dows = (uint8_t)((bits[4] | (bits[4] >> 7)) & 0x7F); // 7 is Sunday too
+	domStar = star[2];
+	dowStar = star[4];
+	ok = true;
+	plan();
+	return true;
+}
+
+// Days of the month that match, bit d = day d. A day field written with
+// '*' (stepped or not) ANDs with the other; both restricted means either
+// may match (classic cron rule). The field bits always apply.
+uint32_t MAX31329_Cron::dayMask(int year, int month) const {
+	uint8_t len = MAX31329::daysInMonth(year, month);
+	uint32_t all = (uint32_t)(cronFrom(1) & ~cronFrom((uint8_t)(len + 1)));
+	uint32_t byDow = all;
+	if (dows != 0x7F) {
+		MAX31329_Time t;
+		t.year = year;
+		t.month = month;
+		t.day = 1;
+		t.hour = t.minute = t.second = 0;
+		MAX31329::epochToTime(MAX31329::timeToEpoch(t), t);
+		uint8_t wd1 = (uint8_t)t.dayOfWeek;
+		byDow = 0;
+		for (uint8_t s = 0; s < 7; ++s) {
+			if (!(dows & (1u << ((wd1 + s) % 7)))) continue;
+			for (uint8_t d = (uint8_t)(s + 1); d <= 31; d = (uint8_t)(d + 7)) byDow |= 1u << d;
+		}
+	}
+	uint32_t m = (domStar || dowStar) ? (doms & byDow) : (doms | byDow);
+	return m & all;
+}
+
+bool MAX31329_Cron::dayMatches(int day, int dow) const {
+	bool d = (doms >> day) & 1;
+	bool w = (dows >> dow) & 1;
+	return (domStar || dowStar) ? (d && w) : (d || w);
+}
+
+bool MAX31329_Cron::matches(int64_t epoch) const {
+	if (!ok) return false;
+	MAX31329_Time t;
+	MAX31329::epochToTime(epoch, t);
+	return ((minutes >> t.minute) & 1) && ((hours >> t.hour) & 1) && ((months >> t.month) & 1) &&
+		dayMatches(t.day, t.dayOfWeek);
+}
+
+bool MAX31329_Cron::next(int64_t after, int64_t &at) const {
+	if (!ok) return false;
+	MAX31329_Time t;
+	MAX31329::epochToTime(MAX31329::floorDiv(after, 60) * 60 + 60, t);
+	int year = t.year;
+	uint8_t mo = (uint8_t)t.month, d = (uint8_t)t.day, h = (uint8_t)t.hour, mi = (uint8_t)t.minute;
+	int lastYear = year + 8;
+	while (year <= lastYear) {
+		uint64_t m = months & cronFrom(mo);
+		if (!m) {
+			++year;
+			mo = cronCtz(months);
+			d = 1;
+			h = mi = 0;
+			continue;
+		}
+		if (cronCtz(m) != mo) {
+			mo = cronCtz(m);
+			d = 1;
+			h = mi = 0;
+		}
+		uint64_t days = dayMask(year, mo) & cronFrom(d);
+		if (!days) {
+			if (++mo > 12) {
+				mo = 1;
+				++year;
+			}
+			d = 1;
+			h = mi = 0;
+			continue;
+		}
+		if (cronCtz(days) != d) {
+			d = cronCtz(days);
+			h = mi = 0;
+		}
+		uint64_t hh = hours & cronFrom(h);
+		if (!hh) {
+			++d;
+			h = mi = 0;
+			continue;
+		}
+		if (cronCtz(hh) != h) {
+			h = cronCtz(hh);
+			mi = 0;
+		}
+		uint64_t mm = minutes & cronFrom(mi);
+		if (!mm) {
+			++h;
+			mi = 0;
+			continue; // h == 24 falls through to the next day above
+		}
+		t.year = year;
+		t.month = mo;
+		t.day = d;
+		t.hour = h;
+		t.minute = cronCtz(mm);
+		t.second = 0;
+		at = MAX31329::timeToEpoch(t);
+		return true;
+	}
+	return false;
+}
+
+// Narrowest mask whose matches are a superset of the expression's
+void MAX31329_Cron::plan() {
+	bool allMin = minutes == (cronFrom(0) & ~cronFrom(60));
+	bool allHour = hours == 0xFFFFFF;
+	bool allMonth = months == 0x1FFE;
+	bool allDom = doms == 0xFFFFFFFE;
+	bool allDow = dows == 0x7F;
+	bool both = domStar || dowStar; // the day fields AND, else OR
+	bool allDays = both ? (allDom && allDow) : (allDom || allDow);
+	bool oneMin = cronCount(minutes) == 1;
+	bool oneHour = cronCount(hours) == 1;
+	bool oneDom = both && allDow && cronCount(doms) == 1;
+	bool oneDow = both && allDom && cronCount(dows) == 1;
+	uint8_t m = cronCtz(minutes), h = cronCtz(hours);
+
+	planAlarm = 2;
+	if (!oneMin) {
+		a2 = MAX31329_Alarm2::everyMinute();
+		planExact = allMin && allHour && allDays && allMonth;
+	} else if (!oneHour) {
+		a2 = MAX31329_Alarm2::atMinute(m);
+		planExact = allHour && allDays && allMonth;
+	} else if (oneDom && cronCount(months) == 1) {
+		planAlarm = 1;
+		a1 = MAX31329_Alarm1::onMonth(cronCtz(months), cronCtz(doms), h, m, 0);
+		planExact = true;
+	} else if (oneDom) {
+		a2 = MAX31329_Alarm2::onDate(cronCtz(doms), h, m);
+		planExact = allMonth;
+	} else if (oneDow) {
+		a2 = MAX31329_Alarm2::onDay(cronCtz(dows), h, m);
+		planExact = allMonth;
+	} else {
+		a2 = MAX31329_Alarm2::atHour(h, m);
+		planExact = allDays && allMonth;
+	}
+}
+
+bool MAX31329_Cron::armNext(MAX31329 &rtc, int64_t now) {
+	int64_t at;
+	if (!next(now, at)) return false;
+	MAX31329_Time t;
+	MAX31329::epochToTime(at, t);
+	return rtc.setAlarm2(MAX31329_Alarm2::onDate((uint8_t)t.day, (uint8_t)t.hour, (uint8_t)t.minute));
+}
+
+bool MAX31329_Cron::arm(MAX31329 &rtc, bool exactWakes) {
+	if (!ok) return false;
+	oneShot = exactWakes && !planExact;
+	if (oneShot) {
+		int64_t now;
+		if (!rtc.readEpoch(now) || !armNext(rtc, now)) return false;
+	} else if (planAlarm == 1) {
+		if (!rtc.setAlarm1(a1)) return false;
+	} else if (!rtc.setAlarm2(a2)) {
+		return false;
+	}
+	return rtc.enableInterrupts(planAlarm == 1 && !oneShot ? MAX31329_INT_A1IE : MAX31329_INT_A2IE);
+}
+
+bool MAX31329_Cron::service(MAX31329 &rtc) {
+	if (!ok) return false;
+	if (planExact) return true;
+	int64_t now;
+	if (!rtc.readEpoch(now)) return false;
+	bool hit = matches(now);
+	if (oneShot) armNext(rtc, now);
+	return hit;
+}
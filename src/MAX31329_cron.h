@@ -0,0 +1,85 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_CRON_H
+#define KODE_MAX31329_CRON_H
+
+#include "kode_MAX31329.h"
+
+// Cron schedules on the RTC alarms. parse() compiles a five-field
+// expression (minute hour day-of-month month day-of-week, with lists,
+// ranges, steps, JAN-DEC/SUN-SAT names and @hourly-style macros) into
+// bitsets, and picks the narrowest alarm mask that fires on every match:
+//
+//   "30 7 * * *"        Alarm2 daily 07:30          exact
+//   "0 9 * * 1"         Alarm2 weekly Monday 09:00  exact
+//   "0 0 24 12 *"       Alarm1 yearly Dec 24        exact
+//   "15 * * * 1-5"      Alarm2 hourly at :15        + weekday filter
+//   "*/15 8-18 * * 1-5" Alarm2 every minute         + filter
+//
+// When the mask is not exact, arm() by default programs Alarm2 with the
+// date and time of the next match instead and service() moves it on after
+// each wake, so the MCU only wakes for matches (Alarm2 holds a date, not a
+// month: a next match more than a month out costs one extra wake per month).
+// With exactWakes false the superset mask stays armed and service()
+// is the software filter.
+// Times are RTC wall time, minute resolution; alarms fire at :00 seconds.
+class MAX31329_Cron {
+public:
+	MAX31329_Cron();
+
+	bool parse(const char *expr);
+	bool valid() const { return ok; }
+
+	bool matches(int64_t epoch) const;
+	// First match strictly after `after` (bit scans per field; false if
+	// nothing matches within 8 years, e.g. "0 0 30 2 *")
+	bool next(int64_t after, int64_t &at) const;
+
+	// Hardware plan
+	bool exact() const { return planExact; }
+	uint8_t alarmUsed() const { return planAlarm; } // 1 or 2
+	const MAX31329_Alarm1 &alarm1() const { return a1; }
+	const MAX31329_Alarm2 &alarm2() const { return a2; }
+
+	// Program the alarm and its interrupt enable
+	bool arm(MAX31329 &rtc, bool exactWakes = true);
+	// Call when the armed alarm flag is seen: true if this wake is a match
+	bool service(MAX31329 &rtc);
+
+private:
+	uint64_t minutes;  // bits 0..59
+	uint32_t hours;    // bits 0..23
+	uint32_t doms;     // bits 1..31
+	uint16_t months;   // bits 1..12
+	uint8_t dows;      // bits 0..6, 0 = Sunday
+	bool domStar;      // day field starts with '*': the day fields AND
+	bool dowStar;
+	bool ok;
+
+	bool planExact;
+	uint8_t planAlarm;
+	bool oneShot;
+	MAX31329_Alarm1 a1;
+	MAX31329_Alarm2 a2;
+
+	uint32_t dayMask(int year, int month) const;
+	bool dayMatches(int day, int dow) const;
+	void plan();
+	bool armNext(MAX31329 &rtc, int64_t now);
+};
+
+#endif // KODE_MAX31329_CRON_H
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_drift.h"
+
+#include <math.h>
+
+MAX31329_DriftEstimator::MAX31329_DriftEstimator(MAX31329 &r)
+	: rtc(r), refFn(nullptr), refCtx(nullptr), autoTrim(true),
+	  qOffset(1.0), qRate(1e-6), ratePrior(50.0) {
+	reset();
+}
+
+void MAX31329_DriftEstimator::setReference(MAX31329_RefSource fn, void *ctx) {
+	refFn = fn;
+	refCtx = ctx;
+}
+
+void MAX31329_DriftEstimator::setProcessNoise(double offsetVar, double rateVar) {
+	qOffset = offsetVar;
+	qRate = rateVar;
+}
+
+void MAX31329_DriftEstimator::setRatePrior(double ppmSigma) {
+	ratePrior = ppmSigma;
+}
+
+void MAX31329_DriftEstimator::reset() {
+	count = 0;
+	lastRtcUs = 0;
+	x0 = x1 = 0;
+	p00 = p01 = p11 = 0;
+}
+
+bool MAX31329_DriftEstimator::observe(bool pinEdge) {
+	if (!refFn) return false;
+	if (pinEdge && !rtc.syncToEdge()) return false;
+	// A time write since the last update cleared the trim: the offset
+	// restarts, the learned rate is kept
+	if (autoTrim && count && !rtc.trimEnabled()) {
+		p00 = 1e18;
+		p01 = 0;
+	}
+	int64_t refUs, capturedUs, rtcUs, localUs;
+	uint32_t refErr, rtcErr;
+	if (!refFn(refUs, capturedUs, refErr, refCtx)) return false;
+	if (!rtc.rawSample(rtcUs, localUs, rtcErr)) return false;
+	// Both clocks at the reference capture instant
+	addObservation(rtcUs - (localUs - capturedUs), refUs, refErr + rtcErr);
+	return true;
+}
+
+void MAX31329_DriftEstimator::addObservation(int64_t rtcEpochUs, int64_t refEpochUs,
+	uint32_t errorUs) {
+	double z = (double)(rtcEpochUs - refEpochUs);
+	// Error bounds are treated as uniform: variance = bound^2 / 3
+	double r = (double)errorUs * errorUs / 3.0 + 1.0;
+
+	if (count == 0) {
+		x0 = z;
+		x1 = 0;
+		p00 = r;
+		p01 = 0;
+		p11 = ratePrior * ratePrior;
+	} else {
+		// Predict: offset integrates the rate over the RTC interval
+		double dt = (double)(rtcEpochUs - lastRtcUs) * 1e-6;
+		x0 += x1 * dt;
+		double n00 = p00 + 2 * dt * p01 + dt * dt * p11 + qOffset * fabs(dt) + qRate * fabs(dt * dt * dt) / 3;
+		double n01 = p01 + dt * p11 + qRate * dt * dt / 2;
+		double n11 = p11 + qRate * fabs(dt);
+		// Update with H = [1 0]
+		double s = n00 + r;
+		double k0 = n00 / s;
+		double k1 = n01 / s;
+		double innov = z - x0;
+		x0 += k0 * innov;
+		x1 += k1 * innov;
+		p00 = (1 - k0) * n00;
+		p01 = (1 - k0) * n01;
+		p11 = n11 - k1 * n01;
+	}
+	lastRtcUs = rtcEpochUs;
+	++count;
+	if (autoTrim) applyTrim();
+}
+
+void MAX31329_DriftEstimator::applyTrim() {
+	rtc.setTrim(lastRtcUs, (int64_t)llround(x0), (int32_t)lround(x1 * 1000.0));
+}
+
+double MAX31329_DriftEstimator::offsetSigmaUs() const {
+	return sqrt(p00);
+}
+
+double MAX31329_DriftEstimator::ppmSigma() const {
+	return sqrt(p11);
+}
+
+double MAX31329_DriftEstimator::predictSigmaUs(double dtSec) const {
+	double v = p00 + 2 * dtSec * p01 + dtSec * dtSec * p11
+		+ qOffset * dtSec + qRate * dtSec * dtSec * dtSec / 3;
+	return sqrt(v > 0 ? v : 0);
+}
+
+uint32_t MAX31329_DriftEstimator::nextResyncMs(uint32_t budgetUs) const {
+	if (count == 0 || predictSigmaUs(0) >= budgetUs) return 0;
+	// The prediction grows monotonically with dt: bisect on [0, 1 day]
+	double lo = 0, hi = 86400;
+	if (predictSigmaUs(hi) <= budgetUs) return 86400000u;
+	for (int i = 0; i < 40; ++i) {
+		double mid = (lo + hi) / 2;
+		if (predictSigmaUs(mid) <= budgetUs) lo = mid;
+		else hi = mid;
+	}
+	return (uint32_t)(lo * 1000);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_DRIFT_H
+#define KODE_MAX31329_DRIFT_H
+
+#include "kode_MAX31329.h"
+
+// Reference clock (NTP, GPS PPS, a fake clock on the host): true UTC epoch
+// microseconds sampled at local time capturedAtUs (the RTC's micros source).
+// errorUs bounds the reference error. Returns false when no sample is available.
+typedef bool (*MAX31329_RefSource)(int64_t &refEpochUs, int64_t &capturedAtUs,
+	uint32_t &errorUs, void *ctx);
+
+// Two-state Kalman filter over the RTC error (offset, rate):
+//   offset(T) = offsetUs + ppm * (T - T_last)    T in RTC seconds
+// Each observation compares one RTC read with one reference sample. The
+// estimate is pushed into the driver with setTrim(), so readTime() and the
+// epoch reads come back corrected between resyncs.
+class MAX31329_DriftEstimator {
+public:
+	explicit MAX31329_DriftEstimator(MAX31329 &rtc);
+
+	void setReference(MAX31329_RefSource fn, void *ctx = nullptr);
+	// Process noise: offset jitter (us^2 per s) and rate random walk (ppm^2 per s)
+	void setProcessNoise(double offsetVar, double rateVar);
+	// Prior rate uncertainty before the second observation (default 50 ppm)
+	void setRatePrior(double ppmSigma);
+	// Push each new estimate into rtc.setTrim() (default on)
+	void setAutoTrim(bool enable) { autoTrim = enable; }
+
+	// Sample the reference and the RTC, then update. Needs fast time for
+	// sub-second RTC reads; with pinEdge the 1 Hz edge is located first
+	// (rtc.syncToEdge(), up to ~1 s of polling), which makes each
+	// observation good to a few hundred microseconds.
+	bool observe(bool pinEdge = true);
+	// Feed an externally measured pair (RTC and reference at the same instant)
+	void addObservation(int64_t rtcEpochUs, int64_t refEpochUs, uint32_t errorUs);
+	void reset();
+
+	uint32_t observations() const { return count; }
+	double offsetUs() const { return x0; }   // at the last observation
+	double ppm() const { return x1; }
+	double offsetSigmaUs() const;
+	double ppmSigma() const;
+	// Predicted 1-sigma error of the trimmed time dtSec after the last observation
+	double predictSigmaUs(double dtSec) const;
+	// Longest wait until the predicted error reaches budgetUs (capped at one day)
+	uint32_t nextResyncMs(uint32_t budgetUs) const;
+
+private:
+	MAX31329 &rtc;
+	MAX31329_RefSource refFn;
+	void *refCtx;
+	bool autoTrim;
+	double qOffset;
+	double qRate;
+	double ratePrior;
+
+	uint32_t count;
+	int64_t lastRtcUs; // RTC time of the last observation
+	double x0, x1;     // offset (us), rate (ppm = us/s)
+	double p00, p01, p11;
+
+	void applyTrim();
+};
+
+#endif // KODE_MAX31329_DRIFT_H
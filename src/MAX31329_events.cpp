@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_events.h"
+
+static_assert((MAX31329_EVENT_QUEUE_LEN & (MAX31329_EVENT_QUEUE_LEN - 1)) == 0,
+	"MAX31329_EVENT_QUEUE_LEN must be a power of two");
+
+MAX31329_Events::MAX31329_Events(MAX31329 &r)
+	: rtc(r), handlers(), head(0), tail(0), stamps(),
+	  overrunCount(0), lastLatency(0), maxLatency(0) {}
+
+bool MAX31329_Events::on(uint8_t flag, MAX31329_EventFn fn, void *arg) {
+	if (flag == 0 || (flag & (flag - 1)) != 0) return false; // exactly one bit
+	uint8_t bit = 0;
+	while (!(flag & (1u << bit))) ++bit;
+	handlers[bit].fn = fn;
+	handlers[bit].arg = arg;
+	return true;
+}
+
+void MAX31329_Events::off(uint8_t flag) {
+	for (uint8_t bit = 0; bit < 8; ++bit) {
+		if (flag & (1u << bit)) handlers[bit].fn = nullptr;
+	}
+}
+
+void IRAM_ATTR MAX31329_Events::notifyFromISR() {
+	uint32_t h = head.load(std::memory_order_relaxed);
+	stamps[h & (MAX31329_EVENT_QUEUE_LEN - 1)] = (uint32_t)micros();
+	head.store(h + 1, std::memory_order_release);
+}
+
+int MAX31329_Events::dispatch(bool force) {
+	uint32_t h = head.load(std::memory_order_acquire);
+	uint32_t t = tail.load(std::memory_order_relaxed);
+	uint32_t edges = h - t;
+	if (edges == 0 && !force) return 0;
+
+	// Counters are free-running, so the edge count stays exact even when
+	// the ring wrapped and only the oldest timestamps were overwritten
+	uint32_t lost = 0;
+	if (edges > MAX31329_EVENT_QUEUE_LEN) {
+		lost = edges - MAX31329_EVENT_QUEUE_LEN;
+		t = h - MAX31329_EVENT_QUEUE_LEN;
+	}
+	uint32_t oldest = edges ? stamps[t & (MAX31329_EVENT_QUEUE_LEN - 1)] : 0;
+
+	// The edges are consumed only by a successful read: STATUS stays latched
+	// and INT low after a failed one, so no new edge would come to retry it
+	uint8_t status;
+	if (!rtc.readStatus(status)) return -1;
+	overrunCount += lost;
+	tail.store(h, std::memory_order_release);
+
+	if (edges) {
+		lastLatency = (uint32_t)micros() - oldest;
+		if (lastLatency > maxLatency) maxLatency = lastLatency;
+	}
+	for (uint8_t bit = 0; bit < 8; ++bit) {
+		if ((status & (1u << bit)) && handlers[bit].fn) {
+			handlers[bit].fn((uint8_t)(1u << bit), edges, handlers[bit].arg);
+		}
+	}
+	return status;
+}
+
+uint32_t MAX31329_Events::pendingEdges() const {
+	return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+}
+
+uint32_t MAX31329_Events::overruns() const {
+	return overrunCount;
+}
+
+uint32_t MAX31329_Events::lastLatencyUs() const {
+	return lastLatency;
+}
+
+uint32_t MAX31329_Events::maxLatencyUs() const {
+	return maxLatency;
+}
+
+void MAX31329_Events::resetLatency() {
+	lastLatency = 0;
+	maxLatency = 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_EVENTS_H
+#define KODE_MAX31329_EVENTS_H
+
+#include <atomic>
+
+#include "kode_MAX31329.h"
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+// ISR edge timestamps kept for latency measurement (power of two)
+#ifndef MAX31329_EVENT_QUEUE_LEN
+#define MAX31329_EVENT_QUEUE_LEN 32
+#endif
+
+// flag: the MAX31329_STATUS_* bit being handled. edges: INT pin edges
+// folded into this STATUS read (at least 1 for ISR-driven dispatches).
+typedef void (*MAX31329_EventFn)(uint8_t flag, uint32_t edges, void *arg);
+
+// Interrupt dispatcher. The GPIO ISR only calls notifyFromISR(), which
+// timestamps the edge into a lock-free single-producer/single-consumer ring.
+// dispatch(), run from a task or loop(), reads STATUS exactly once (which
+// also clears it and releases the INT pin) and calls the handler of every
+// flag that was latched. Flags latched between edges are never lost because
+// STATUS is only read here.
+class MAX31329_Events {
+public:
+	explicit MAX31329_Events(MAX31329 &rtc);
+
+	// Register a handler for one STATUS bit (A1F, A2F, TIF, DIF, PFAIL, OSF, PSDECT)
+	bool on(uint8_t flag, MAX31329_EventFn fn, void *arg = nullptr);
+	void off(uint8_t flag);
+
+	// ISR side: timestamp the edge and return
+	void IRAM_ATTR notifyFromISR();
+
+	// Task side: handle pending edges with a single STATUS read. With force,
+	// STATUS is read even without a pending edge (polling). Returns the
+	// STATUS flags seen, 0 when nothing was pending, or -1 on bus error
+	// (the edges then stay pending for the next call).
+	int dispatch(bool force = false);
+
+	uint32_t pendingEdges() const;
+	uint32_t overruns() const;      // edges whose timestamps were overwritten
+	uint32_t lastLatencyUs() const; // oldest edge to handler start, last dispatch
+	uint32_t maxLatencyUs() const;
+	void resetLatency();
+
+private:
+	struct Handler {
+		MAX31329_EventFn fn;
+		void *arg;
+	};
+
+	MAX31329 &rtc;
+	Handler handlers[8];
+	std::atomic<uint32_t> head; // written by the ISR only
+	std::atomic<uint32_t> tail; // written by dispatch() only
+	uint32_t stamps[MAX31329_EVENT_QUEUE_LEN];
+	uint32_t overrunCount;
+	uint32_t lastLatency;
+	uint32_t maxLatency;
+};
+
+#endif // KODE_MAX31329_EVENTS_H
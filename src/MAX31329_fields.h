@@ -0,0 +1,160 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_FIELDS_H
+#define KODE_MAX31329_FIELDS_H
+
+#include <stdint.h>
+
+#include "MAX31329_registers.h"
+
+// Typed register field descriptors. Every field knows its register,
+// position, width and access, so encoding is a constexpr expression and
+// misuse is a compile error. MAX31329_registers.h keeps the flat masks.
+
+enum MAX31329_Access : uint8_t {
+	MAX31329_ACCESS_RW,
+	MAX31329_ACCESS_RO,  // writes are ignored by the chip
+	MAX31329_ACCESS_RC   // read-only, cleared by reading (STATUS)
+};
+
+template <uint8_t Reg, uint8_t Pos, uint8_t Width, MAX31329_Access Access = MAX31329_ACCESS_RW>
+struct MAX31329_Field {
+	static_assert(Width >= 1 && Pos + Width <= 8, "field must fit in one register");
+
+	static constexpr uint8_t reg = Reg;
+	static constexpr uint8_t pos = Pos;
+	static constexpr uint8_t width = Width;
+	static constexpr MAX31329_Access access = Access;
+	static constexpr uint8_t max = (uint8_t)((1u << Width) - 1);
+	static constexpr uint8_t mask = (uint8_t)(max << Pos);
+
+	// Runtime values are truncated to the field width (the setters' contract)
+	static constexpr uint8_t encode(uint8_t v) { return (uint8_t)((v & max) << Pos); }
+	static constexpr uint8_t decode(uint8_t regValue) { return (uint8_t)((regValue & mask) >> Pos); }
+};
+
+// A field with a compile-time value; out-of-range values and read-only
+// fields are rejected when the template is used
+template <typename Field, uint8_t Value>
+struct MAX31329_Set {
+	static_assert(Value <= Field::max, "value does not fit the field");
+	static_assert(Field::access == MAX31329_ACCESS_RW, "field is read-only");
+
+	static constexpr uint8_t reg = Field::reg;
+	static constexpr uint8_t mask = Field::mask;
+	static constexpr uint8_t value = (uint8_t)(Value << Field::pos);
+};
+
+// Folds a pack of MAX31329_Set into one mask/value per register
+template <typename... Sets>
+struct MAX31329_FieldSet {
+	static constexpr uint32_t regs() { return 0; }
+	static constexpr uint8_t mask(uint8_t) { return 0; }
+	static constexpr uint8_t value(uint8_t) { return 0; }
+	static constexpr bool disjoint() { return true; }
+};
+
+template <typename S, typename... Rest>
+struct MAX31329_FieldSet<S, Rest...> {
+	typedef MAX31329_FieldSet<Rest...> Tail;
+
+	static constexpr uint32_t regs() { return (1ul << S::reg) | Tail::regs(); }
+	static constexpr uint8_t mask(uint8_t r) {
+		return (uint8_t)((S::reg == r ? S::mask : 0) | Tail::mask(r));
+	}
+	static constexpr uint8_t value(uint8_t r) {
+		return (uint8_t)((S::reg == r ? S::value : 0) | Tail::value(r));
+	}
+	// No two entries may set the same bits
+	static constexpr bool disjoint() {
+		return (Tail::mask(S::reg) & S::mask) == 0 && Tail::disjoint();
+	}
+};
+
+// Emits one setBits(reg, mask, value) per distinct register of Set, with
+// mask and value as compile-time constants (at the last entry for a register)
+template <typename Set, typename... Sets>
+struct MAX31329_FieldStager {
+	template <typename Tx> static void apply(Tx &) {}
+};
+
+template <typename Set, typename S, typename... Rest>
+struct MAX31329_FieldStager<Set, S, Rest...> {
+	template <typename Tx> static void apply(Tx &tx) {
+		static constexpr uint8_t m = Set::mask(S::reg);
+		static constexpr uint8_t v = Set::value(S::reg);
+		if (!(MAX31329_FieldSet<Rest...>::regs() & (1ul << S::reg))) tx.setBits(S::reg, m, v);
+		MAX31329_FieldStager<Set, Rest...>::apply(tx);
+	}
+};
+
+// INT_EN
+typedef MAX31329_Field<MAX31329_REG_INT_EN, MAX31329_INT_A1IE_POS, 1>   MAX31329_FIELD_A1IE;
+typedef MAX31329_Field<MAX31329_REG_INT_EN, MAX31329_INT_A2IE_POS, 1>   MAX31329_FIELD_A2IE;
+typedef MAX31329_Field<MAX31329_REG_INT_EN, MAX31329_INT_TIE_POS, 1>    MAX31329_FIELD_TIE;
+typedef MAX31329_Field<MAX31329_REG_INT_EN, MAX31329_INT_DIE_POS, 1>    MAX31329_FIELD_DIE;
+typedef MAX31329_Field<MAX31329_REG_INT_EN, MAX31329_INT_PFAILE_POS, 1> MAX31329_FIELD_PFAILE;
+typedef MAX31329_Field<MAX31329_REG_INT_EN, MAX31329_INT_DOSF_POS, 1>   MAX31329_FIELD_DOSF;
+
+// STATUS (clear on read)
+typedef MAX31329_Field<MAX31329_REG_STATUS, MAX31329_STATUS_A1F_POS, 1, MAX31329_ACCESS_RC>    MAX31329_FIELD_A1F;
+typedef MAX31329_Field<MAX31329_REG_STATUS, MAX31329_STATUS_A2F_POS, 1, MAX31329_ACCESS_RC>    MAX31329_FIELD_A2F;
+typedef MAX31329_Field<MAX31329_REG_STATUS, MAX31329_STATUS_TIF_POS, 1, MAX31329_ACCESS_RC>    MAX31329_FIELD_TIF;
+typedef MAX31329_Field<MAX31329_REG_STATUS, MAX31329_STATUS_DIF_POS, 1, MAX31329_ACCESS_RC>    MAX31329_FIELD_DIF;
+typedef MAX31329_Field<MAX31329_REG_STATUS, MAX31329_STATUS_PFAIL_POS, 1, MAX31329_ACCESS_RC>  MAX31329_FIELD_PFAIL;
+typedef MAX31329_Field<MAX31329_REG_STATUS, MAX31329_STATUS_OSF_POS, 1, MAX31329_ACCESS_RC>    MAX31329_FIELD_OSF;
+typedef MAX31329_Field<MAX31329_REG_STATUS, MAX31329_STATUS_PSDECT_POS, 1, MAX31329_ACCESS_RC> MAX31329_FIELD_PSDECT;
+
+// RTC_RESET, CFG1
+typedef MAX31329_Field<MAX31329_REG_RTC_RESET, 0, 1> MAX31329_FIELD_SWRST;
+typedef MAX31329_Field<MAX31329_REG_CFG1, 0, 1>      MAX31329_FIELD_ENOSC;
+typedef MAX31329_Field<MAX31329_REG_CFG1, 1, 1>      MAX31329_FIELD_I2C_TIMEOUT;
+typedef MAX31329_Field<MAX31329_REG_CFG1, 2, 1>      MAX31329_FIELD_DATA_RET;
+typedef MAX31329_Field<MAX31329_REG_CFG1, 3, 1>      MAX31329_FIELD_ENIO;
+
+// CFG2
+typedef MAX31329_Field<MAX31329_REG_CFG2, MAX31329_CFG2_CLKIN_HZ_POS, 2> MAX31329_FIELD_CLKIN_HZ;
+typedef MAX31329_Field<MAX31329_REG_CFG2, 2, 1>                          MAX31329_FIELD_ENCLKIN;
+typedef MAX31329_Field<MAX31329_REG_CFG2, 3, 1>                          MAX31329_FIELD_DIP;
+typedef MAX31329_Field<MAX31329_REG_CFG2, MAX31329_CFG2_CLKO_HZ_POS, 2>  MAX31329_FIELD_CLKO_HZ;
+typedef MAX31329_Field<MAX31329_REG_CFG2, 7, 1>                          MAX31329_FIELD_ENCLKO;
+
+// TIMER_CONFIG, TIMER_COUNT, TIMER_INIT
+typedef MAX31329_Field<MAX31329_REG_TIMER_CONFIG, MAX31329_TMR_TFS_POS, 2> MAX31329_FIELD_TFS;
+typedef MAX31329_Field<MAX31329_REG_TIMER_CONFIG, 2, 1>                    MAX31329_FIELD_TRPT;
+typedef MAX31329_Field<MAX31329_REG_TIMER_CONFIG, 3, 1>                    MAX31329_FIELD_TPAUSE;
+typedef MAX31329_Field<MAX31329_REG_TIMER_CONFIG, 4, 1>                    MAX31329_FIELD_TE;
+typedef MAX31329_Field<MAX31329_REG_TIMER_COUNT, 0, 8, MAX31329_ACCESS_RO> MAX31329_FIELD_TIMER_COUNT;
+typedef MAX31329_Field<MAX31329_REG_TIMER_INIT, 0, 8>                      MAX31329_FIELD_TIMER_INIT;
+
+// PWR_MGMT, TRICKLE
+typedef MAX31329_Field<MAX31329_REG_PWR_MGMT, 0, 1>                        MAX31329_FIELD_DMAN_SEL;
+typedef MAX31329_Field<MAX31329_REG_PWR_MGMT, 1, 1>                        MAX31329_FIELD_D_VBACK_SEL;
+typedef MAX31329_Field<MAX31329_REG_PWR_MGMT, MAX31329_PWR_PFVT_POS, 2>    MAX31329_FIELD_PFVT;
+typedef MAX31329_Field<MAX31329_REG_TRICKLE, MAX31329_TRK_D_TRICKLE_POS, 4> MAX31329_FIELD_D_TRICKLE;
+typedef MAX31329_Field<MAX31329_REG_TRICKLE, 7, 1>                         MAX31329_FIELD_TRKCHG_EN;
+
+// The descriptors must agree with the flat masks
+static_assert(MAX31329_FIELD_CLKO_HZ::mask == MAX31329_CFG2_CLKO_HZ_MASK, "CLKO_HZ");
+static_assert(MAX31329_FIELD_ENCLKO::mask == MAX31329_CFG2_ENCLKO, "ENCLKO");
+static_assert(MAX31329_FIELD_TFS::mask == MAX31329_TMR_TFS_MASK, "TFS");
+static_assert(MAX31329_FIELD_TE::mask == MAX31329_TMR_TE, "TE");
+static_assert(MAX31329_FIELD_PFVT::mask == MAX31329_PWR_PFVT_MASK, "PFVT");
+static_assert(MAX31329_FIELD_D_TRICKLE::mask == MAX31329_TRK_D_TRICKLE_MASK, "D_TRICKLE");
+static_assert(MAX31329_FIELD_TRKCHG_EN::mask == MAX31329_TRK_D_TRKCHG_EN, "TRKCHG_EN");
+
+#endif // KODE_MAX31329_FIELDS_H
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_fleet.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+#include <algorithm>
+
+static_assert(MAX31329_FLEET_MAX_BUSES <= 8, "busMask is 8 bits wide");
+
+#if defined(ARDUINO_ARCH_ESP32)
+// Worker exit bits sit above the per-bus round bits in the event group
+static const uint8_t FLEET_EXIT_SHIFT = 8;
+#endif
+
+static int64_t fleetMicros() {
+#if defined(ARDUINO_ARCH_ESP32)
+	return esp_timer_get_time();
+#else
+	return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+MAX31329_Fleet::MAX31329_Fleet()
+	: devices(), count(0), busMask(0), microsFn(fleetMicros), results(), pollUs(0)
+#if defined(ARDUINO_ARCH_ESP32)
+	, workers(), done(nullptr), running(false), generation(0)
+#endif
+{}
+
+MAX31329_Fleet::~MAX31329_Fleet() {
+	stop();
+#if defined(ARDUINO_ARCH_ESP32)
+	if (done) vEventGroupDelete(done);
+#endif
+}
+
+int MAX31329_Fleet::add(MAX31329 &rtc, uint8_t busId) {
+	if (count >= MAX31329_FLEET_MAX_DEVICES || busId >= MAX31329_FLEET_MAX_BUSES) return -1;
+#if defined(ARDUINO_ARCH_ESP32)
+	if (running) return -1; // workers already split the device list
+#endif
+	devices[count].rtc = &rtc;
+	devices[count].bus = busId;
+	busMask |= (uint8_t)(1u << busId);
+	return (int)count++;
+}
+
+void MAX31329_Fleet::setMicrosSource(MAX31329_MicrosFn fn) {
+	microsFn = fn ? fn : fleetMicros;
+}
+
+void MAX31329_Fleet::pollBus(uint8_t bus) {
+	for (size_t i = 0; i < count; ++i) {
+		if (devices[i].bus != bus) continue;
+		MAX31329_FleetSample &s = results[i];
+		int64_t t0 = microsFn();
+		s.ok = devices[i].rtc->readEpochMs(s.epochMs);
+		s.capturedUs = t0 + (microsFn() - t0) / 2;
+	}
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void MAX31329_Fleet::workerMain(void *arg) {
+	Worker *w = static_cast<Worker *>(arg);
+	MAX31329_Fleet *f = w->fleet;
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		if (!f->running) break;
+		uint32_t gen = f->generation;
+		f->pollBus(w->bus);
+		// A round that poll() has given up on is not reported: the pending
+		// notification starts the current one right away
+		if (gen != f->generation) continue;
+		w->generation = gen;
+		xEventGroupSetBits(f->done, 1u << w->bus);
+	}
+	// Report the exit so stop() knows the bus is no longer in use. This is
+	// the worker's last use of the event group.
+	w->task = nullptr;
+	xEventGroupSetBits(f->done, 1u << (FLEET_EXIT_SHIFT + w->bus));
+	vTaskDelete(nullptr);
+}
+
+bool MAX31329_Fleet::start(uint8_t priority) {
+	if (running) return true;
+	if (!done) done = xEventGroupCreate();
+	if (!done) return false;
+	running = true;
+	for (uint8_t b = 0; b < MAX31329_FLEET_MAX_BUSES; ++b) {
+		if (!(busMask & (1u << b))) continue;
+		workers[b].fleet = this;
+		workers[b].bus = b;
+		workers[b].generation = generation;
+		if (xTaskCreate(workerMain, "max31329_fleet", MAX31329_FLEET_STACK,
+			&workers[b], priority, &workers[b].task) != pdPASS) {
+			stop();
+			return false;
+		}
+	}
+	return true;
+}
+
+void MAX31329_Fleet::stop() {
+	if (!running) return;
+	running = false;
+	EventBits_t live = 0;
+	xEventGroupClearBits(done, 0xFFFF);
+	for (uint8_t b = 0; b < MAX31329_FLEET_MAX_BUSES; ++b) {
+		if (workers[b].task) {
+			live |= 1u << (FLEET_EXIT_SHIFT + b);
+			xTaskNotifyGive(workers[b].task);
+		}
+	}
+	if (live) xEventGroupWaitBits(done, live, pdTRUE, pdTRUE, portMAX_DELAY);
+}
+
+size_t MAX31329_Fleet::poll(MAX31329_FleetSample *out, uint32_t timeoutMs) {
+	if (!out) return 0;
+	int64_t t0 = microsFn();
+	if (running) {
+		// A new round: workers still busy with an abandoned one do not report
+		// it, and bits they set before noticing are checked against it here
+		uint32_t gen = ++generation;
+		xEventGroupClearBits(done, busMask);
+		for (uint8_t b = 0; b < MAX31329_FLEET_MAX_BUSES; ++b) {
+			if (workers[b].task) xTaskNotifyGive(workers[b].task);
+		}
+		TickType_t start = xTaskGetTickCount();
+		TickType_t limit = pdMS_TO_TICKS(timeoutMs);
+		uint8_t pending = busMask;
+		while (pending) {
+			TickType_t waited = xTaskGetTickCount() - start;
+			if (waited >= limit) break;
+			EventBits_t got = xEventGroupWaitBits(done, pending, pdTRUE, pdFALSE, limit - waited);
+			for (uint8_t b = 0; b < MAX31329_FLEET_MAX_BUSES; ++b) {
+				if ((got & pending & (1u << b)) && workers[b].generation == gen) pending &= (uint8_t)~(1u << b);
+			}
+		}
+		// A late worker may still be writing its results[]; only the buses
+		// that reported this round are copied
+		pollUs = (uint32_t)(microsFn() - t0);
+		return collect(out, pending);
+	}
+	for (size_t i = 0; i < count; ++i) results[i].ok = false;
+	for (uint8_t b = 0; b < MAX31329_FLEET_MAX_BUSES; ++b) {
+		if (busMask & (1u << b)) pollBus(b);
+	}
+	pollUs = (uint32_t)(microsFn() - t0);
+	return collect(out, 0);
+}
+#else
+bool MAX31329_Fleet::start(uint8_t priority) {
+	(void)priority;
+	return true;
+}
+
+void MAX31329_Fleet::stop() {}
+
+// One bus after the other against the same deadline: a bus still reading
+// when it passes, and every bus after it, is late
+size_t MAX31329_Fleet::poll(MAX31329_FleetSample *out, uint32_t timeoutMs) {
+	if (!out) return 0;
+	int64_t t0 = microsFn();
+	int64_t limitUs = (int64_t)timeoutMs * 1000;
+	uint8_t late = 0;
+	for (uint8_t b = 0; b < MAX31329_FLEET_MAX_BUSES; ++b) {
+		if (!(busMask & (1u << b))) continue;
+		if (microsFn() - t0 <= limitUs) pollBus(b);
+		if (microsFn() - t0 > limitUs) late |= (uint8_t)(1u << b);
+	}
+	pollUs = (uint32_t)(microsFn() - t0);
+	return collect(out, late);
+}
+#endif
+
+size_t MAX31329_Fleet::collect(MAX31329_FleetSample *out, uint8_t late) const {
+	size_t good = 0;
+	for (size_t i = 0; i < count; ++i) {
+		if (late & (1u << devices[i].bus)) {
+			out[i].ok = false;
+			continue;
+		}
+		out[i] = results[i];
+		good += out[i].ok;
+	}
+	return good;
+}
+
+bool MAX31329_Fleet::median(const MAX31329_FleetSample *samples, size_t n, int64_t atUs,
+	uint32_t toleranceMs, int64_t &epochMs, size_t *agree) {
+	int64_t v[MAX31329_FLEET_MAX_DEVICES];
+	size_t m = 0;
+	for (size_t i = 0; i < n && m < MAX31329_FLEET_MAX_DEVICES; ++i) {
+		if (!samples[i].ok) continue;
+		v[m++] = samples[i].epochMs + (atUs - samples[i].capturedUs) / 1000;
+	}
+	if (agree) *agree = 0;
+	if (m == 0) return false;
+	std::sort(v, v + m);
+	// Lower median keeps the result an observed value for even counts
+	epochMs = v[(m - 1) / 2];
+	size_t votes = 0;
+	for (size_t i = 0; i < m; ++i) {
+		int64_t d = v[i] - epochMs;
+		if (d <= (int64_t)toleranceMs && -d <= (int64_t)toleranceMs) ++votes;
+	}
+	if (agree) *agree = votes;
+	return votes * 2 > m;
+}
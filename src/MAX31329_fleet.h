@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_FLEET_H
+#define KODE_MAX31329_FLEET_H
+
+#include "kode_MAX31329.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/event_groups.h>
+#endif
+
+#ifndef MAX31329_FLEET_MAX_DEVICES
+#define MAX31329_FLEET_MAX_DEVICES 8
+#endif
+
+// Bounded by the completion bits of a FreeRTOS event group
+#ifndef MAX31329_FLEET_MAX_BUSES
+#define MAX31329_FLEET_MAX_BUSES 4
+#endif
+
+#ifndef MAX31329_FLEET_STACK
+#define MAX31329_FLEET_STACK 3072
+#endif
+
+struct MAX31329_FleetSample {
+	int64_t epochMs;    // device time (ms resolution with enableFastTime())
+	int64_t capturedUs; // local time at the middle of the read
+	bool ok;
+};
+
+// Polls several MAX31329s spread over independent I2C buses. Each bus gets
+// its own worker task that reads its devices back to back, so a poll takes
+// as long as the slowest bus instead of the sum of all buses. Without
+// FreeRTOS (host builds) the buses are polled one after the other against
+// the same timeout.
+class MAX31329_Fleet {
+public:
+	MAX31329_Fleet();
+	~MAX31329_Fleet();
+
+	// Register a started device on bus busId (0..MAX31329_FLEET_MAX_BUSES-1).
+	// Returns its index in poll() results, or -1 when full.
+	int add(MAX31329 &rtc, uint8_t busId);
+	size_t size() const { return count; }
+
+	// Spawn one worker per used bus (no-op on host builds)
+	bool start(uint8_t priority = 5);
+	void stop();
+
+	// Read every device. out[] receives size() samples in add() order.
+	// Returns the number of successful reads. On a timeout the buses that
+	// finished keep their samples and the devices of the late ones fail.
+	size_t poll(MAX31329_FleetSample *out, uint32_t timeoutMs = 100);
+	uint32_t lastPollUs() const { return pollUs; }
+
+	// Project every good sample to the common instant atUs and take the
+	// median. agree counts samples within toleranceMs of it. Returns false
+	// when fewer than a strict majority of the good samples agree.
+	static bool median(const MAX31329_FleetSample *samples, size_t n, int64_t atUs,
+		uint32_t toleranceMs, int64_t &epochMs, size_t *agree = nullptr);
+
+	void setMicrosSource(MAX31329_MicrosFn fn);
+
+private:
+	struct Device {
+		MAX31329 *rtc;
+		uint8_t bus;
+	};
+
+	Device devices[MAX31329_FLEET_MAX_DEVICES];
+	size_t count;
+	uint8_t busMask;
+	MAX31329_MicrosFn microsFn;
+	MAX31329_FleetSample results[MAX31329_FLEET_MAX_DEVICES];
+	uint32_t pollUs;
+
+	void pollBus(uint8_t bus);
+	size_t collect(MAX31329_FleetSample *out, uint8_t late) const;
+
+#if defined(ARDUINO_ARCH_ESP32)
+	struct Worker {
+		MAX31329_Fleet *fleet;
+		uint8_t bus;
+		TaskHandle_t task;
+		volatile uint32_t generation; // last poll round this bus completed
+	};
+	Worker workers[MAX31329_FLEET_MAX_BUSES];
+	EventGroupHandle_t done;  // bit b: bus b finished a round; bit 8+b: worker b exited
+	volatile bool running;
+	volatile uint32_t generation; // current poll round
+	static void workerMain(void *arg);
+#endif
+};
+
+#endif // KODE_MAX31329_FLEET_H
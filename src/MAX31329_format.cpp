@@ -0,0 +1,192 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_format.h"
+
+#include <string.h>
+
+const char MAX31329_Format::DIGITS[200] = {
+	'0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+	'1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+	'2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+	'3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+	'4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+	'5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+	'6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+	'7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+	'8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+	'9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+};
+
+char *MAX31329_Format::put2(char *p, unsigned v) {
+	const char *d = &DIGITS[(v % 100) * 2];
+	p[0] = d[0];
+	p[1] = d[1];
+	return p + 2;
+}
+
+char *MAX31329_Format::put3(char *p, unsigned v) {
+	v %= 1000;
+	*p++ = (char)('0' + v / 100);
+	return put2(p, v % 100);
+}
+
+char *MAX31329_Format::putDate(char *p, int year, unsigned month, unsigned day, bool compact) {
+	p = put2(p, (unsigned)year / 100);
+	p = put2(p, (unsigned)year % 100);
+	if (!compact) *p++ = '-';
+	p = put2(p, month);
+	if (!compact) *p++ = '-';
+	p = put2(p, day);
+	*p++ = 'T';
+	return p;
+}
+
+char *MAX31329_Format::putTime(char *p, unsigned h, unsigned m, unsigned s, bool compact) {
+	p = put2(p, h);
+	if (!compact) *p++ = ':';
+	p = put2(p, m);
+	if (!compact) *p++ = ':';
+	return put2(p, s);
+}
+
+char *MAX31329_Format::putTail(char *p, unsigned ms, uint8_t flags) {
+	if (flags & MAX31329_FMT_MILLIS) {
+		*p++ = '.';
+		p = put3(p, ms);
+	}
+	if (flags & MAX31329_FMT_UTC) *p++ = 'Z';
+	*p = '\0';
+	return p;
+}
+
+size_t MAX31329_Format::length(uint8_t flags) {
+	size_t n = (flags & MAX31329_FMT_COMPACT) ? 15 : 19;
+	if (flags & MAX31329_FMT_MILLIS) n += 4;
+	if (flags & MAX31329_FMT_UTC) n += 1;
+	return n;
+}
+
+size_t MAX31329_Format::iso8601(char *buf, size_t size, const MAX31329_Time &t, uint8_t flags) {
+	size_t n = length(flags);
+	if (!buf || size <= n || t.year < 0 || t.year > 9999) return 0;
+	bool compact = (flags & MAX31329_FMT_COMPACT) != 0;
+	char *p = putDate(buf, t.year, (unsigned)t.month, (unsigned)t.day, compact);
+	p = putTime(p, (unsigned)t.hour, (unsigned)t.minute, (unsigned)t.second, compact);
+	putTail(p, (unsigned)t.millisecond, flags);
+	return n;
+}
+
+size_t MAX31329_Format::iso8601Bcd(char *buf, size_t size, const uint8_t *regs, uint8_t flags) {
+	size_t n = length(flags);
+	if (!buf || !regs || size <= n) return 0;
+	bool compact = (flags & MAX31329_FMT_COMPACT) != 0;
+	// Each BCD nibble is one decimal digit; the century bit picks 20xx/21xx
+	const uint8_t in[6] = {
+		regs[6],                                            // year
+		(uint8_t)(regs[5] & 0x1F),                          // month
+		(uint8_t)(regs[4] & 0x3F),                          // date
+		(uint8_t)(regs[2] & 0x3F),                          // hours
+		(uint8_t)(regs[1] & 0x7F),                          // minutes
+		(uint8_t)(regs[0] & 0x7F),                          // seconds
+	};
+	static const char sep[6] = {'-', '-', 'T', ':', ':', '\0'};
+	char *p = buf;
+	*p++ = '2';
+	*p++ = (regs[5] & 0x80) ? '1' : '0';
+	for (uint8_t i = 0; i < 6; ++i) {
+		*p++ = (char)('0' + (in[i] >> 4));
+		*p++ = (char)('0' + (in[i] & 0x0F));
+		if (i == 2) *p++ = 'T';
+		else if (i < 5 && !compact) *p++ = sep[i];
+	}
+	putTail(p, 0, flags);
+	return n;
+}
+
+size_t MAX31329_Format::timeOfDay(char *buf, size_t size, const MAX31329_Time &t, uint8_t flags) {
+	bool compact = (flags & MAX31329_FMT_COMPACT) != 0;
+	size_t n = (compact ? 6 : 8) + ((flags & MAX31329_FMT_MILLIS) ? 4 : 0) +
+		((flags & MAX31329_FMT_UTC) ? 1 : 0);
+	if (!buf || size <= n) return 0;
+	char *p = putTime(buf, (unsigned)t.hour, (unsigned)t.minute, (unsigned)t.second, compact);
+	putTail(p, (unsigned)t.millisecond, flags);
+	return n;
+}
+
+MAX31329_Stamper::MAX31329_Stamper(uint8_t f)
+	: flags(f), cachedDay(INT64_MIN), cachedYmd(-1), cachedMinute(-1), prefix(), dateLen(0),
+	  prefixLen(0), rebuilds(0) {}
+
+void MAX31329_Stamper::setDate(int year, unsigned month, unsigned day) {
+	dateLen = (uint8_t)(MAX31329_Format::putDate(prefix, year, month, day,
+		(flags & MAX31329_FMT_COMPACT) != 0) - prefix);
+	cachedMinute = -1;
+}
+
+void MAX31329_Stamper::setMinute(unsigned minuteOfDay) {
+	bool compact = (flags & MAX31329_FMT_COMPACT) != 0;
+	char *p = MAX31329_Format::put2(prefix + dateLen, minuteOfDay / 60);
+	if (!compact) *p++ = ':';
+	p = MAX31329_Format::put2(p, minuteOfDay % 60);
+	if (!compact) *p++ = ':';
+	prefixLen = (uint8_t)(p - prefix);
+	cachedMinute = (int16_t)minuteOfDay;
+	++rebuilds;
+}
+
+size_t MAX31329_Stamper::finish(char *buf, size_t size, unsigned s, unsigned ms) {
+	size_t n = MAX31329_Format::length(flags);
+	if (!buf || size <= n) return 0;
+	memcpy(buf, prefix, prefixLen);
+	char *p = MAX31329_Format::put2(buf + prefixLen, s);
+	MAX31329_Format::putTail(p, ms, flags);
+	return n;
+}
+
+size_t MAX31329_Stamper::stamp(char *buf, size_t size, int64_t epochMs) {
+	int64_t day = epochMs / 86400000;
+	int64_t rem = epochMs % 86400000;
+	if (rem < 0) {
+		rem += 86400000;
+		--day;
+	}
+	if (day != cachedDay) {
+		MAX31329_Time t;
+		MAX31329::epochToTime(day * 86400, t);
+		if (t.year < 0 || t.year > 9999) return 0;
+		setDate(t.year, (unsigned)t.month, (unsigned)t.day);
+		cachedDay = day;
+		cachedYmd = -1;
+	}
+	uint32_t ms = (uint32_t)rem;
+	uint32_t secs = ms / 1000;
+	if ((int16_t)(secs / 60) != cachedMinute) setMinute(secs / 60);
+	return finish(buf, size, secs % 60, ms % 1000);
+}
+
+size_t MAX31329_Stamper::stamp(char *buf, size_t size, const MAX31329_Time &t) {
+	if (t.year < 0 || t.year > 9999) return 0;
+	int32_t ymd = t.year * 10000 + t.month * 100 + t.day;
+	if (ymd != cachedYmd) {
+		setDate(t.year, (unsigned)t.month, (unsigned)t.day);
+		cachedYmd = ymd;
+		cachedDay = INT64_MIN;
+	}
+	int16_t minute = (int16_t)(t.hour * 60 + t.minute);
+	if (minute != cachedMinute) setMinute((unsigned)minute);
+	return finish(buf, size, (unsigned)t.second, (unsigned)t.millisecond);
+}
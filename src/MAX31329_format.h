@@ -0,0 +1,84 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_FORMAT_H
+#define KODE_MAX31329_FORMAT_H
+
+#include "kode_MAX31329.h"
+
+// Format flags
+#define MAX31329_FMT_MILLIS   (1u << 0)  // append .mmm
+#define MAX31329_FMT_UTC      (1u << 1)  // append Z (RFC 3339)
+#define MAX31329_FMT_COMPACT  (1u << 2)  // YYYYMMDDTHHMMSS, no separators
+
+// Largest output plus terminator: YYYY-MM-DDTHH:MM:SS.mmmZ
+#define MAX31329_FMT_MAX_LEN  25
+
+// Timestamp formatters. Digits come from a two-digit lookup table (or
+// straight from the BCD nibbles), with no printf, no division chains and no
+// heap. Every call writes a NUL-terminated string into the caller's buffer
+// and returns its length, or 0 (buffer untouched) when it does not fit.
+class MAX31329_Format {
+public:
+	// ISO 8601 / RFC 3339 from a decoded time (millisecond used with MAX31329_FMT_MILLIS)
+	static size_t iso8601(char *buf, size_t size, const MAX31329_Time &t, uint8_t flags = 0);
+	// Same, straight from the 7 time registers (SECONDS..YEAR, as read by
+	// readBytes(MAX31329_REG_SECONDS, regs, 7)); no binary conversion at all
+	static size_t iso8601Bcd(char *buf, size_t size, const uint8_t *regs, uint8_t flags = 0);
+	// Time of day only: HH:MM:SS[.mmm] (HHMMSS with MAX31329_FMT_COMPACT)
+	static size_t timeOfDay(char *buf, size_t size, const MAX31329_Time &t, uint8_t flags = 0);
+
+	static size_t length(uint8_t flags);
+
+private:
+	friend class MAX31329_Stamper;
+	static const char DIGITS[200];
+	static char *put2(char *p, unsigned v);
+	static char *put3(char *p, unsigned v);
+	static char *putDate(char *p, int year, unsigned month, unsigned day, bool compact);
+	static char *putTime(char *p, unsigned h, unsigned m, unsigned s, bool compact);
+	static char *putTail(char *p, unsigned ms, uint8_t flags);
+};
+
+// Batch stamping for logs: records from the same minute reuse the formatted
+// "date, hour and minute" prefix, so only the seconds are emitted per record.
+// The calendar conversion runs once per day change.
+class MAX31329_Stamper {
+public:
+	explicit MAX31329_Stamper(uint8_t flags = MAX31329_FMT_MILLIS | MAX31329_FMT_UTC);
+
+	size_t stamp(char *buf, size_t size, int64_t epochMs); // e.g. from readEpochMs()
+	size_t stamp(char *buf, size_t size, const MAX31329_Time &t);
+
+	// Prefix rebuilds: one per minute (or date) change between records
+	uint32_t prefixRebuilds() const { return rebuilds; }
+
+private:
+	uint8_t flags;
+	int64_t cachedDay;     // days since 1970 (epoch input)
+	int32_t cachedYmd;     // yyyymmdd (MAX31329_Time input)
+	int16_t cachedMinute;  // minute of the day in the prefix, -1 for none
+	char prefix[18];       // "YYYY-MM-DDTHH:MM:" or "YYYYMMDDTHHMM"
+	uint8_t dateLen;
+	uint8_t prefixLen;
+	uint32_t rebuilds;
+
+	void setDate(int year, unsigned month, unsigned day);
+	void setMinute(unsigned minuteOfDay);
+	size_t finish(char *buf, size_t size, unsigned s, unsigned ms);
+};
+
+#endif // KODE_MAX31329_FORMAT_H
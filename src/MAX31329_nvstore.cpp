@@ -0,0 +1,220 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_nvstore.h"
+
+#include <string.h>
+
+MAX31329_NvStore::MAX31329_NvStore(MAX31329 &r, uint8_t offset, uint8_t length)
+	: rtc(r), base(offset), bankSize(0), image(), unknown(0), work(), used(0),
+	  active(1), seq(0), isLoaded(false), isDirty(false) {
+	if ((uint16_t)offset + length > MAX31329_RAM_SIZE) {
+		length = (offset < MAX31329_RAM_SIZE) ? (uint8_t)(MAX31329_RAM_SIZE - offset) : 0;
+	}
+	bankSize = length / 2;
+	if (bankSize < HEADER + 4) bankSize = 0; // too small to hold one record
+}
+
+// CRC-8, polynomial 0x31 (as used by Dallas/Maxim parts), MSB first
+uint8_t MAX31329_NvStore::crc8(const uint8_t *data, size_t length, uint8_t crc) {
+	while (length--) {
+		crc ^= *data++;
+		for (uint8_t i = 0; i < 8; ++i) {
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+bool MAX31329_NvStore::bankValid(uint8_t bank, uint8_t &payload) const {
+	const uint8_t *b = image + bank * bankSize;
+	if (crc8(b, 1) != b[1]) return false;
+	uint8_t cap = bankSize - HEADER;
+	const uint8_t *p = b + HEADER;
+	uint8_t i = 0;
+	while (i < cap && p[i] != END) {
+		if (i + 2 > cap) return false;
+		uint8_t rec = (uint8_t)(3 + p[i + 1]);
+		if (i + rec > cap) return false;
+		if (crc8(p + i, rec - 1) != p[i + rec - 1]) return false;
+		i += rec;
+	}
+	payload = i;
+	return true;
+}
+
+bool MAX31329_NvStore::load() {
+	if (!bankSize) return false;
+	if (!rtc.readRam(base, image, (size_t)bankSize * 2)) return false;
+	unknown = 0;
+
+	uint8_t len0 = 0, len1 = 0;
+	bool v0 = bankValid(0, len0);
+	bool v1 = bankValid(1, len1);
+	if (v0 && v1) {
+		// Sequence numbers wrap; the newer bank is ahead by less than half the range
+		active = ((int8_t)(image[bankSize] - image[0]) > 0) ? 1 : 0;
+	} else if (v0 || v1) {
+		active = v0 ? 0 : 1;
+	} else {
+		active = 1; // next commit goes to bank 0
+		seq = 0;
+		used = 0;
+		isLoaded = true;
+		isDirty = false;
+		return true;
+	}
+	const uint8_t *b = image + active * bankSize;
+	seq = b[0];
+	used = active ? len1 : len0;
+	memcpy(work, b + HEADER, used);
+	isLoaded = true;
+	isDirty = false;
+	return true;
+}
+
+int MAX31329_NvStore::find(uint8_t key) const {
+	uint8_t i = 0;
+	while (i < used) {
+		if (work[i] == key) return i;
+		i = (uint8_t)(i + 3 + work[i + 1]);
+	}
+	return -1;
+}
+
+bool MAX31329_NvStore::get(uint8_t key, void *data, uint8_t length) const {
+	int i = find(key);
+	if (i < 0 || work[i + 1] != length || !data) return false;
+	memcpy(data, work + i + 2, length);
+	return true;
+}
+
+int MAX31329_NvStore::size(uint8_t key) const {
+	int i = find(key);
+	return (i < 0) ? -1 : work[i + 1];
+}
+
+size_t MAX31329_NvStore::freeSpace() const {
+	if (!bankSize) return 0;
+	uint8_t cap = bankSize - HEADER;
+	return (used + 3u < cap) ? cap - used - 3u : 0;
+}
+
+bool MAX31329_NvStore::put(uint8_t key, const void *data, uint8_t length) {
+	if (key == END || !bankSize || (!data && length)) return false;
+	uint8_t cap = bankSize - HEADER;
+	int i = find(key);
+	if (i >= 0 && work[i + 1] == length) {
+		// Same size: update in place so the record keeps its position and
+		// only its data and CRC bytes become dirty
+		if (memcmp(work + i + 2, data, length) == 0) return true;
+		memcpy(work + i + 2, data, length);
+		work[i + 2 + length] = crc8(work + i, (size_t)length + 2);
+		isDirty = true;
+		return true;
+	}
+	uint8_t old = (i >= 0) ? (uint8_t)(3 + work[i + 1]) : 0;
+	if ((size_t)used - old + 3 + length > cap) return false;
+	if (i >= 0) remove(key);
+	uint8_t *r = work + used;
+	r[0] = key;
+	r[1] = length;
+	memcpy(r + 2, data, length);
+	r[2 + length] = crc8(r, (size_t)length + 2);
+	used = (uint8_t)(used + 3 + length);
+	isDirty = true;
+	return true;
+}
+
+bool MAX31329_NvStore::remove(uint8_t key) {
+	int i = find(key);
+	if (i < 0) return false;
+	uint8_t rec = (uint8_t)(3 + work[i + 1]);
+	memmove(work + i, work + i + rec, used - i - rec);
+	used = (uint8_t)(used - rec);
+	isDirty = true;
+	return true;
+}
+
+void MAX31329_NvStore::clear() {
+	if (used) isDirty = true;
+	used = 0;
+}
+
+bool MAX31329_NvStore::flush(uint8_t start, const uint8_t *want, uint8_t length,
+	size_t &written) {
+	const uint8_t *have = image + start;
+	uint64_t stale = unknown >> start;
+	uint8_t i = 0;
+	while (i < length) {
+		if (want[i] == have[i] && !((stale >> i) & 1)) { ++i; continue; }
+		// Extend the run over differing bytes and short unchanged gaps
+		uint8_t end = (uint8_t)(i + 1);
+		uint8_t j = end;
+		while (j < length) {
+			if (want[j] != have[j] || ((stale >> j) & 1)) {
+				end = (uint8_t)(j + 1);
+			} else if (j - end >= MAX31329_NV_MERGE_GAP) {
+				break;
+			}
+			++j;
+		}
+		uint64_t run = (end - i < 64 ? ((1ULL << (end - i)) - 1) : ~0ULL) << (start + i);
+		if (!rtc.writeRam((uint8_t)(base + start + i), want + i, end - i)) {
+			// A torn burst may have stored any prefix of the run
+			unknown |= run;
+			return false;
+		}
+		memcpy(image + start + i, want + i, end - i);
+		unknown &= ~run;
+		written += end - i;
+		i = end;
+	}
+	return true;
+}
+
+bool MAX31329_NvStore::commit(size_t *bytesWritten) {
+	size_t written = 0;
+	if (bytesWritten) *bytesWritten = 0;
+	if (!isLoaded) return false;
+	if (!isDirty) return true;
+
+	uint8_t target = active ^ 1;
+	uint8_t start = (uint8_t)(target * bankSize);
+	uint8_t cap = bankSize - HEADER;
+
+	// Payload first; the terminator is only needed when the bank is not full
+	uint8_t payload[MAX31329_RAM_SIZE / 2];
+	memcpy(payload, work, used);
+	uint8_t len = used;
+	if (len < cap) payload[len++] = END;
+
+	// A failed write marks its whole run unknown in image[] (the device may
+	// hold any prefix of it), so the next commit rewrites that run in full
+	if (!flush((uint8_t)(start + HEADER), payload, len, written)) return false;
+
+	// The header goes last: until it lands, load() still prefers the old bank
+	uint8_t header[HEADER];
+	header[0] = (uint8_t)(seq + 1);
+	header[1] = crc8(header, 1);
+	if (!flush(start, header, HEADER, written)) return false;
+
+	seq = header[0];
+	active = target;
+	isDirty = false;
+	if (bytesWritten) *bytesWritten = written;
+	return true;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_NVSTORE_H
+#define KODE_MAX31329_NVSTORE_H
+
+#include "kode_MAX31329.h"
+
+#define MAX31329_RAM_SIZE (MAX31329_REG_RAM_END - MAX31329_REG_RAM_START + 1)
+
+// Unchanged bytes between two dirty runs that are still rewritten to save a
+// transfer (one transfer costs about address + register byte + ACK overhead)
+#ifndef MAX31329_NV_MERGE_GAP
+#define MAX31329_NV_MERGE_GAP 2
+#endif
+
+// Key/value store over an NVRAM window, double-buffered for power-loss safety.
+//
+// The window is split into two banks:
+//   bank:   [seq][hdr crc8][record]...[0xFF terminator]
+//   record: [key][len][data...][crc8 of key, len, data]
+// The valid bank with the newest sequence number is active. commit() rewrites
+// the other bank: the records first, then the header last. A commit torn by
+// power loss leaves a bank that is stale or fails its CRC, and load() then
+// falls back to the previous bank. All reads are served from a RAM mirror.
+// A commit writes only the bytes that differ from the mirror of the target
+// bank, in merged bursts.
+class MAX31329_NvStore {
+public:
+	// offset/length select the NVRAM window (relative to 0x22)
+	explicit MAX31329_NvStore(MAX31329 &rtc, uint8_t offset = 0,
+		uint8_t length = MAX31329_RAM_SIZE);
+
+	// One burst read of the window. Starts empty if neither bank is valid.
+	bool load();
+	bool commit(size_t *bytesWritten = nullptr);
+
+	// Mirror-only accessors (no I2C). Key 0xFF is reserved.
+	bool get(uint8_t key, void *data, uint8_t length) const;
+	int size(uint8_t key) const;  // -1 when missing
+	bool put(uint8_t key, const void *data, uint8_t length);
+	bool remove(uint8_t key);
+	void clear();
+
+	template <typename T> bool get(uint8_t key, T &value) const {
+		return get(key, &value, (uint8_t)sizeof(T));
+	}
+	template <typename T> bool put(uint8_t key, const T &value) {
+		return put(key, &value, (uint8_t)sizeof(T));
+	}
+
+	bool dirty() const { return isDirty; }
+	bool loaded() const { return isLoaded; }
+	uint8_t sequence() const { return seq; }
+	size_t freeSpace() const;
+
+	static uint8_t crc8(const uint8_t *data, size_t length, uint8_t crc = 0xFF);
+
+private:
+	static const uint8_t HEADER = 2;
+	static const uint8_t END = 0xFF;
+
+	MAX31329 &rtc;
+	uint8_t base;
+	uint8_t bankSize;
+	uint8_t image[MAX31329_RAM_SIZE]; // what the device window holds
+	uint64_t unknown; // image[] bytes a failed write may have changed
+	uint8_t work[MAX31329_RAM_SIZE / 2]; // pending payload of the next commit
+	uint8_t used;
+	uint8_t active;
+	uint8_t seq;
+	bool isLoaded;
+	bool isDirty;
+
+	int find(uint8_t key) const;
+	bool bankValid(uint8_t bank, uint8_t &payload) const;
+	bool flush(uint8_t start, const uint8_t *want, uint8_t length, size_t &written);
+};
+
+#endif // KODE_MAX31329_NVSTORE_H
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_powerfail.h"
+
+#include <string.h>
+
+MAX31329_PowerFail::MAX31329_PowerFail(MAX31329 &r, uint8_t offset, uint8_t length)
+	: rtc(r), events(nullptr), base(offset), size(0), frame(), frameLen(0), seq(0),
+	  lastUs(0), worstUs(0), worstTotal(0), commitCount(0) {
+	if ((uint16_t)offset + length > MAX31329_RAM_SIZE) {
+		length = (offset < MAX31329_RAM_SIZE) ? (uint8_t)(MAX31329_RAM_SIZE - offset) : 0;
+	}
+	size = (length > MAX31329_PF_OVERHEAD) ? length : 0;
+}
+
+// CRC over [seq][len][payload][padding][marker], taken with the given marker
+static uint8_t recordCrc(const uint8_t *rec, uint8_t size, uint8_t marker) {
+	uint8_t buf[MAX31329_RAM_SIZE];
+	memcpy(buf, rec, (size_t)size - 2);
+	buf[size - 2] = marker;
+	return MAX31329_NvStore::crc8(buf, (size_t)size - 1);
+}
+
+MAX31329_PowerFailState MAX31329_PowerFail::restore(void *data, uint8_t maxLength,
+	uint8_t *length) {
+	if (length) *length = 0;
+	uint8_t rec[MAX31329_RAM_SIZE];
+	if (!size || !rtc.readRam(base, rec, size)) return MAX31329_PF_INVALID;
+	uint8_t len = rec[1];
+	if (len > size - MAX31329_PF_OVERHEAD) return MAX31329_PF_INVALID;
+	MAX31329_PowerFailState state;
+	if (rec[size - 2] == MARK_COMMITTED) state = MAX31329_PF_COMMITTED;
+	else if (rec[size - 2] == MARK_ARMED) state = MAX31329_PF_ARMED;
+	else return MAX31329_PF_INVALID;
+	// arm() only flips the marker, so an armed record still checks as the
+	// committed one. A torn burst never reached the CRC byte: the stale CRC
+	// fails on whatever the burst did overwrite, the marker included.
+	if (recordCrc(rec, size, MARK_COMMITTED) != rec[size - 1]) return MAX31329_PF_INVALID;
+	seq = rec[0];
+	if (data) memcpy(data, rec + 2, len < maxLength ? len : maxLength);
+	if (length) *length = len;
+	return state;
+}
+
+bool MAX31329_PowerFail::arm() {
+	if (!size) return false;
+	uint8_t mark = MARK_ARMED;
+	if (!rtc.writeRam((uint8_t)(base + size - 2), &mark, 1)) return false;
+	return rtc.enableInterrupts(MAX31329_INT_PFAILE);
+}
+
+bool MAX31329_PowerFail::stage(const void *data, uint8_t length) {
+	if (!size || length > size - MAX31329_PF_OVERHEAD || (!data && length)) return false;
+	memset(frame, 0, size);
+	frame[0] = ++seq;
+	frame[1] = length;
+	memcpy(frame + 2, data, length);
+	frame[size - 2] = MARK_COMMITTED;
+	frame[size - 1] = recordCrc(frame, size, MARK_COMMITTED);
+	frameLen = size;
+	return true;
+}
+
+bool MAX31329_PowerFail::commit() {
+	if (!frameLen) return false;
+	uint32_t t0 = (uint32_t)micros();
+	bool ok = rtc.writeRam(base, frame, frameLen);
+	lastUs = (uint32_t)micros() - t0;
+	if (lastUs > worstUs) worstUs = lastUs;
+	if (ok) ++commitCount;
+	return ok;
+}
+
+void MAX31329_PowerFail::attach(MAX31329_Events &ev) {
+	events = &ev;
+	ev.on(MAX31329_STATUS_PFAIL, onPowerFail, this);
+}
+
+void MAX31329_PowerFail::onPowerFail(uint8_t flag, uint32_t edges, void *arg) {
+	(void)flag;
+	(void)edges;
+	MAX31329_PowerFail *pf = static_cast<MAX31329_PowerFail *>(arg);
+	pf->commit();
+	// The dispatcher measured edge-to-handler; add the burst itself
+	uint32_t total = pf->events->lastLatencyUs() + pf->lastUs;
+	if (total > pf->worstTotal) pf->worstTotal = total;
+}
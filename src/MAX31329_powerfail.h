@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_POWERFAIL_H
+#define KODE_MAX31329_POWERFAIL_H
+
+#include "kode_MAX31329.h"
+#include "MAX31329_events.h"
+#include "MAX31329_nvstore.h"
+
+// Record overhead: [seq][len] ... [marker][crc8]
+#define MAX31329_PF_OVERHEAD 4
+
+enum MAX31329_PowerFailState {
+	MAX31329_PF_INVALID,   // CRC mismatch: torn commit, or the region was never used
+	MAX31329_PF_ARMED,     // armed but no commit happened (old data intact)
+	MAX31329_PF_COMMITTED  // the power-fail commit completed
+};
+
+// Power-fail commit path. The critical state is staged ahead of time as a
+// complete NVRAM record filling the region: sequence, length, payload,
+// padding, marker and, in the region's last byte, a CRC over all of them.
+// On PFAIL the record goes out in a single writeBytes() burst, with no
+// formatting or allocation at that point. The CRC is the last byte of the
+// burst, so restore() after power returns only reports a commit whose burst
+// reached the end.
+class MAX31329_PowerFail {
+public:
+	// offset/length: NVRAM region (relative to 0x22), payload up to length - 4
+	MAX31329_PowerFail(MAX31329 &rtc, uint8_t offset, uint8_t length);
+
+	// Boot: read the region back. On COMMITTED/ARMED the payload is copied
+	// to data (up to maxLength bytes) and its length stored in *length.
+	MAX31329_PowerFailState restore(void *data, uint8_t maxLength, uint8_t *length = nullptr);
+
+	// Mark the region armed (so a stale record is not mistaken for a new
+	// commit) and enable the PFAIL interrupt
+	bool arm();
+
+	// Serialize the state to commit; call whenever it changes
+	bool stage(const void *data, uint8_t length);
+	template <typename T> bool stage(const T &value) {
+		return stage(&value, (uint8_t)sizeof(T));
+	}
+
+	// Write the staged record now (one burst). Normally called through attach().
+	bool commit();
+
+	// Run commit() from the dispatcher's PFAIL handler
+	void attach(MAX31329_Events &events);
+
+	uint32_t lastCommitUs() const { return lastUs; }   // burst duration
+	uint32_t worstCommitUs() const { return worstUs; }
+	// Worst PFAIL edge to end of burst, when attached to a dispatcher
+	uint32_t worstTotalUs() const { return worstTotal; }
+	uint32_t commits() const { return commitCount; }
+
+private:
+	static const uint8_t MARK_ARMED = 0xA5;
+	static const uint8_t MARK_COMMITTED = 0x5A;
+
+	MAX31329 &rtc;
+	MAX31329_Events *events;
+	uint8_t base;
+	uint8_t size;
+	uint8_t frame[MAX31329_RAM_SIZE];
+	uint8_t frameLen;
+	uint8_t seq;
+	uint32_t lastUs;
+	uint32_t worstUs;
+	uint32_t worstTotal;
+	uint32_t commitCount;
+
+	static void onPowerFail(uint8_t flag, uint32_t edges, void *arg);
+};
+
+#endif // KODE_MAX31329_POWERFAIL_H
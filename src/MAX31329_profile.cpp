@@ -0,0 +1,164 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_profile.h"
+
+#include <string.h>
+
+// Burst 0x01-0x19: configuration, the time registers in between, alarms and the rest
+#define PROFILE_BURST (MAX31329_REG_TRICKLE - MAX31329_REG_INT_EN + 1)
+#define PROFILE_LOW 5   // 0x01-0x05
+#define PROFILE_HIGH 13 // 0x0D-0x19
+
+MAX31329_Profile::MAX31329_Profile() : regs(), nv(), withRam(false) {}
+
+int MAX31329_Profile::indexOf(uint8_t reg) {
+	if (reg >= MAX31329_REG_INT_EN && reg < MAX31329_REG_INT_EN + PROFILE_LOW) return reg - MAX31329_REG_INT_EN;
+	if (reg >= MAX31329_REG_ALM1_SEC && reg <= MAX31329_REG_TRICKLE) return PROFILE_LOW + (reg - MAX31329_REG_ALM1_SEC);
+	return -1;
+}
+
+// live[] in profile layout
+bool MAX31329_Profile::readLive(MAX31329 &rtc, uint8_t *live, uint8_t *liveRam, bool ram) {
+	uint8_t burst[PROFILE_BURST];
+	if (!rtc.readBytes(MAX31329_REG_INT_EN, burst, sizeof(burst))) return false;
+	memcpy(live, burst, PROFILE_LOW);
+	memcpy(live + PROFILE_LOW, burst + (MAX31329_REG_ALM1_SEC - MAX31329_REG_INT_EN), PROFILE_HIGH);
+	return !ram || rtc.readRam(0, liveRam, MAX31329_RAM_SIZE);
+}
+
+bool MAX31329_Profile::capture(MAX31329 &rtc, bool ram) {
+	uint8_t live[MAX31329_PROFILE_REGS];
+	uint8_t liveRam[MAX31329_RAM_SIZE];
+	if (!readLive(rtc, live, liveRam, ram)) return false;
+	memcpy(regs, live, sizeof(regs));
+	regs[MAX31329_REG_RTC_RESET - MAX31329_REG_INT_EN] &= (uint8_t)~MAX31329_RESET_SWRST;
+	withRam = ram;
+	if (ram) memcpy(nv, liveRam, sizeof(nv));
+	return true;
+}
+
+// Write the bytes of want[] that differ from have[] starting at base,
+// merging runs separated by up to MAX31329_NV_MERGE_GAP equal bytes
+// (cheaper than another transfer). TIMER_COUNT is read-only and splits runs.
+bool MAX31329_Profile::writeRuns(MAX31329 &rtc, uint8_t base, const uint8_t *want,
+	const uint8_t *have, uint8_t n, size_t &bytes, size_t &transfers) {
+	uint8_t i = 0;
+	while (i < n) {
+		if (want[i] == have[i] || base + i == MAX31329_REG_TIMER_COUNT) {
+			++i;
+			continue;
+		}
+		uint8_t start = i, end = (uint8_t)(i + 1);
+		for (uint8_t j = end; j < n && base + j != MAX31329_REG_TIMER_COUNT; ++j) {
+			if (want[j] == have[j]) continue;
+			if (j - end > MAX31329_NV_MERGE_GAP) break;
+			end = (uint8_t)(j + 1);
+		}
+		if (!rtc.writeBytes((uint8_t)(base + start), want + start, end - start)) return false;
+		bytes += end - start;
+		++transfers;
+		i = end;
+	}
+	return true;
+}
+
+bool MAX31329_Profile::apply(MAX31329 &rtc, size_t *bytesWritten, size_t *transfers) {
+	uint8_t live[MAX31329_PROFILE_REGS];
+	uint8_t liveRam[MAX31329_RAM_SIZE];
+	size_t bytes = 0, count = 0;
+	if (bytesWritten) *bytesWritten = 0;
+	if (transfers) *transfers = 0;
+	if (!readLive(rtc, live, liveRam, withRam)) return false;
+	uint8_t want[MAX31329_PROFILE_REGS];
+	memcpy(want, regs, sizeof(want));
+	want[MAX31329_REG_RTC_RESET - MAX31329_REG_INT_EN] &= (uint8_t)~MAX31329_RESET_SWRST;
+	// Alarms, timer and power before the interrupt enables, so a newly
+	// enabled interrupt sees its final alarm values
+	bool ok = writeRuns(rtc, MAX31329_REG_ALM1_SEC, want + PROFILE_LOW, live + PROFILE_LOW,
+			PROFILE_HIGH, bytes, count) &&
+		writeRuns(rtc, MAX31329_REG_INT_EN, want, live, PROFILE_LOW, bytes, count) &&
+		(!withRam || writeRuns(rtc, MAX31329_REG_RAM_START, nv, liveRam, MAX31329_RAM_SIZE, bytes, count));
+	if (bytesWritten) *bytesWritten = bytes;
+	if (transfers) *transfers = count;
+	return ok;
+}
+
+int MAX31329_Profile::verify(MAX31329 &rtc) {
+	MAX31329_Profile live;
+	if (!live.capture(rtc, withRam)) return -1;
+	return diff(live);
+}
+
+int MAX31329_Profile::diff(const MAX31329_Profile &other) const {
+	int n = 0;
+	for (uint8_t i = 0; i < MAX31329_PROFILE_REGS; ++i) {
+		if (PROFILE_LOW + (MAX31329_REG_TIMER_COUNT - MAX31329_REG_ALM1_SEC) == i) continue;
+		n += regs[i] != other.regs[i];
+	}
+	if (withRam && other.withRam) {
+		for (uint8_t i = 0; i < MAX31329_RAM_SIZE; ++i) n += nv[i] != other.nv[i];
+	}
+	return n;
+}
+
+size_t MAX31329_Profile::serialize(uint8_t *buf, size_t size) const {
+	size_t n = serializedSize();
+	if (!buf || size < n) return 0;
+	buf[0] = MAX31329_PROFILE_VERSION;
+	buf[1] = withRam ? 1 : 0;
+	memcpy(buf + 2, regs, sizeof(regs));
+	if (withRam) memcpy(buf + 2 + sizeof(regs), nv, sizeof(nv));
+	buf[n - 1] = MAX31329_NvStore::crc8(buf, n - 1);
+	return n;
+}
+
+bool MAX31329_Profile::deserialize(const uint8_t *buf, size_t size) {
+	if (!buf || size < MAX31329_PROFILE_SIZE(false) || buf[0] != MAX31329_PROFILE_VERSION ||
+		buf[1] > 1) {
+		return false;
+	}
+	bool ram = buf[1] != 0;
+	size_t n = MAX31329_PROFILE_SIZE(ram);
+	if (size < n || MAX31329_NvStore::crc8(buf, n - 1) != buf[n - 1]) return false;
+	memcpy(regs, buf + 2, sizeof(regs));
+	withRam = ram;
+	if (ram) memcpy(nv, buf + 2 + sizeof(regs), sizeof(nv));
+	return true;
+}
+
+bool MAX31329_Profile::get(uint8_t reg, uint8_t &value) const {
+	int i = indexOf(reg);
+	if (i < 0) return false;
+	value = regs[i];
+	return true;
+}
+
+bool MAX31329_Profile::set(uint8_t reg, uint8_t value) {
+	int i = indexOf(reg);
+	if (i < 0 || reg == MAX31329_REG_TIMER_COUNT) return false;
+	if (reg == MAX31329_REG_RTC_RESET) value &= (uint8_t)~MAX31329_RESET_SWRST;
+	regs[i] = value;
+	return true;
+}
+
+bool MAX31329_Profile::setRam(const uint8_t *data, size_t length, size_t offset) {
+	if (!data || offset > MAX31329_RAM_SIZE || length > MAX31329_RAM_SIZE - offset) return false;
+	if (!withRam) memset(nv, 0, sizeof(nv));
+	memcpy(nv + offset, data, length);
+	withRam = true;
+	return true;
+}
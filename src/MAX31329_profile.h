@@ -0,0 +1,75 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_PROFILE_H
+#define KODE_MAX31329_PROFILE_H
+
+#include "kode_MAX31329.h"
+#include "MAX31329_nvstore.h"
+
+#define MAX31329_PROFILE_VERSION 1
+// Configuration bytes: 0x01-0x05 and 0x0D-0x19
+#define MAX31329_PROFILE_REGS 18
+// Serialized: [version][flags][regs][ram?][crc8]
+#define MAX31329_PROFILE_SIZE(withRam) (3 + MAX31329_PROFILE_REGS + ((withRam) ? MAX31329_RAM_SIZE : 0))
+
+// Device configuration image for provisioning and boot-time checks:
+// interrupt enables, reset, CFG1/CFG2, timer config, both alarms, timer
+// init, power management and trickle charger, plus optionally the 64 bytes
+// of NVRAM. The time registers and TIMER_COUNT are never written back, and
+// SWRST is masked so applying a profile cannot reset the chip.
+//
+// capture() is one burst over 0x01-0x19 (one more for NVRAM). apply()
+// reads the live device the same way and writes only differing runs:
+// alarms, timer and power first, interrupt enables and CFG last.
+class MAX31329_Profile {
+public:
+	MAX31329_Profile();
+
+	bool capture(MAX31329 &rtc, bool withRam = false);
+	// bytesWritten/transfers: payload bytes and write bursts actually sent
+	bool apply(MAX31329 &rtc, size_t *bytesWritten = nullptr, size_t *transfers = nullptr);
+	// Differing bytes between the profile and the live device (0 = match),
+	// -1 on bus error. Costs the same reads as capture().
+	int verify(MAX31329 &rtc);
+	// Differing bytes between two profiles (NVRAM only when both carry it)
+	int diff(const MAX31329_Profile &other) const;
+
+	// Returns the serialized length, or 0 when buf is too small
+	size_t serialize(uint8_t *buf, size_t size) const;
+	// false on a short buffer, unknown version or CRC mismatch
+	bool deserialize(const uint8_t *buf, size_t size);
+	size_t serializedSize() const { return MAX31329_PROFILE_SIZE(withRam); }
+
+	// Edit a profile offline; reg is an address in the covered ranges
+	bool get(uint8_t reg, uint8_t &value) const;
+	bool set(uint8_t reg, uint8_t value);
+	bool hasRam() const { return withRam; }
+	const uint8_t *ram() const { return withRam ? nv : nullptr; }
+	bool setRam(const uint8_t *data, size_t length, size_t offset = 0);
+
+private:
+	uint8_t regs[MAX31329_PROFILE_REGS];
+	uint8_t nv[MAX31329_RAM_SIZE];
+	bool withRam;
+
+	static int indexOf(uint8_t reg);
+	static bool readLive(MAX31329 &rtc, uint8_t *live, uint8_t *liveRam, bool withRam);
+	static bool writeRuns(MAX31329 &rtc, uint8_t base, const uint8_t *want, const uint8_t *have,
+		uint8_t n, size_t &bytes, size_t &transfers);
+};
+
+#endif // KODE_MAX31329_PROFILE_H
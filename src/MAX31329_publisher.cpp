@@ -0,0 +1,212 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_publisher.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+static int64_t publisherMicros() {
+#if defined(ARDUINO_ARCH_ESP32)
+	return esp_timer_get_time();
+#else
+	return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+MAX31329_Publisher::MAX31329_Publisher(MAX31329 &r)
+	: rtc(r), microsFn(publisherMicros), pollStatus(false), current(0), retries(0), last(), haveTime(false)
+#if defined(ARDUINO_ARCH_ESP32)
+	, task(nullptr), running(false), periodMs(0)
+#endif
+{
+	for (uint8_t s = 0; s < 2; ++s) {
+		slots[s].seq.store(0, std::memory_order_relaxed);
+		for (uint8_t i = 0; i < WORDS; ++i) slots[s].w[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+MAX31329_Publisher::~MAX31329_Publisher() {
+	stop();
+}
+
+void MAX31329_Publisher::setMicrosSource(MAX31329_MicrosFn fn) {
+	microsFn = fn ? fn : publisherMicros;
+}
+
+// Writes go to the slot readers are not looking at, then advance current.
+// The per-slot sequence is odd while the slot is being written.
+void MAX31329_Publisher::store(const MAX31329_PublishedTime &p) {
+	uint32_t gen = current.load(std::memory_order_relaxed) + 1;
+	Slot &s = slots[gen & 1];
+	uint32_t seq = s.seq.load(std::memory_order_relaxed);
+	s.seq.store(seq + 1, std::memory_order_relaxed);
+	uint32_t w[WORDS];
+	w[0] = (uint32_t)p.epochMs;
+	w[1] = (uint32_t)((uint64_t)p.epochMs >> 32);
+	w[2] = (uint32_t)p.capturedUs;
+	w[3] = (uint32_t)((uint64_t)p.capturedUs >> 32);
+	w[4] = p.errorMs;
+	w[5] = p.sequence;
+	w[6] = p.failures;
+	w[7] = (uint32_t)p.status | ((uint32_t)p.lastFlags << 8) | ((uint32_t)p.trimmed << 16) |
+		(1u << 24); // valid
+	w[8] = p.lastFlagsSeq;
+	// Release on each word keeps the odd sequence visible before any of them;
+	// no standalone fences, so ThreadSanitizer can follow the protocol
+	for (uint8_t i = 0; i < WORDS; ++i) s.w[i].store(w[i], std::memory_order_release);
+	s.seq.store(seq + 2, std::memory_order_release);
+	current.store(gen, std::memory_order_release);
+}
+
+bool MAX31329_Publisher::publish() {
+	MAX31329_PublishedTime p = last;
+	++p.sequence;
+	int64_t ms;
+	uint32_t err;
+	int64_t t0 = microsFn();
+	bool ok = rtc.readEpochMs(ms, &err);
+	int64_t t1 = microsFn();
+	if (ok) {
+		p.epochMs = ms;
+		p.capturedUs = t0 + (t1 - t0) / 2;
+		p.errorMs = err;
+		p.failures = 0;
+		p.trimmed = rtc.trimEnabled();
+	} else {
+		++p.failures;
+	}
+	if (pollStatus) {
+		uint8_t st;
+		if (rtc.readStatus(st)) {
+			p.status = st;
+			if (st) {
+				p.lastFlags = st;
+				p.lastFlagsSeq = p.sequence;
+			}
+		} else {
+			ok = false;
+		}
+	}
+	last = p;
+	// Nothing to hand out until the first good time read
+	if (p.failures == 0) haveTime = true;
+	if (haveTime) store(p);
+	return ok;
+}
+
+bool MAX31329_Publisher::read(MAX31329_PublishedTime &out) const {
+	uint32_t w[WORDS];
+	for (uint8_t attempt = 0; attempt < MAX31329_PUBLISHER_TRIES; ++attempt) {
+		uint32_t gen = current.load(std::memory_order_acquire);
+		const Slot &s = slots[gen & 1];
+		uint32_t s1 = s.seq.load(std::memory_order_acquire);
+		if (!(s1 & 1)) {
+			for (uint8_t i = 0; i < WORDS; ++i) w[i] = s.w[i].load(std::memory_order_acquire);
+			// The slot may hold a newer store than gen, one not yet made
+			// current; returning it would let the next read go backwards.
+			// A whole counter (not just the slot bit) rules out ABA.
+			if (s.seq.load(std::memory_order_relaxed) == s1 &&
+				current.load(std::memory_order_relaxed) == gen) {
+				if (!(w[7] & (1u << 24))) return false;
+				out.epochMs = (int64_t)((uint64_t)w[0] | ((uint64_t)w[1] << 32));
+				out.capturedUs = (int64_t)((uint64_t)w[2] | ((uint64_t)w[3] << 32));
+				out.errorMs = w[4];
+				out.sequence = w[5];
+				out.failures = w[6];
+				out.status = (uint8_t)w[7];
+				out.lastFlags = (uint8_t)(w[7] >> 8);
+				out.trimmed = (w[7] >> 16) & 1;
+				out.lastFlagsSeq = w[8];
+				return true;
+			}
+		}
+		retries.fetch_add(1, std::memory_order_relaxed);
+	}
+	return false;
+}
+
+bool MAX31329_Publisher::readEpochMs(int64_t &epochMs) const {
+	MAX31329_PublishedTime p;
+	if (!read(p)) return false;
+	int64_t d = microsFn() - p.capturedUs;
+	epochMs = p.epochMs + (d >= 0 ? d / 1000 : -((999 - d) / 1000));
+	return true;
+}
+
+bool MAX31329_Publisher::readTime(MAX31329_Time &t) const {
+	int64_t ms;
+	if (!readEpochMs(ms)) return false;
+	int64_t sec = ms / 1000;
+	int32_t rem = (int32_t)(ms % 1000);
+	if (rem < 0) {
+		rem += 1000;
+		--sec;
+	}
+	MAX31329::epochToTime(sec, t);
+	t.millisecond = rem;
+	return true;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void MAX31329_Publisher::taskMain(void *arg) {
+	MAX31329_Publisher *p = static_cast<MAX31329_Publisher *>(arg);
+	TickType_t wake = xTaskGetTickCount();
+	TickType_t period = pdMS_TO_TICKS(p->periodMs);
+	if (period == 0) period = 1;
+	while (p->running) {
+		p->publish();
+		vTaskDelayUntil(&wake, period);
+	}
+	p->task = nullptr;
+	vTaskDelete(nullptr);
+}
+
+bool MAX31329_Publisher::start(uint32_t period, uint8_t priority, int core) {
+	if (running) return true;
+	periodMs = period;
+	running = true;
+	BaseType_t affinity = core < 0 ? tskNO_AFFINITY : (BaseType_t)core;
+	TaskHandle_t h = nullptr;
+	if (xTaskCreatePinnedToCore(taskMain, "max31329_pub", MAX31329_PUBLISHER_STACK, this,
+		priority, &h, affinity) != pdPASS) {
+		running = false;
+		return false;
+	}
+	task = h;
+	return true;
+}
+
+void MAX31329_Publisher::stop() {
+	if (!running) return;
+	running = false;
+	// The task finishes its current poll and clears its handle on the way out
+	while (task) vTaskDelay(1);
+}
+#else
+bool MAX31329_Publisher::start(uint32_t period, uint8_t priority, int core) {
+	(void)period;
+	(void)priority;
+	(void)core;
+	return true;
+}
+
+void MAX31329_Publisher::stop() {}
+#endif
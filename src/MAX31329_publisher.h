@@ -0,0 +1,108 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_PUBLISHER_H
+#define KODE_MAX31329_PUBLISHER_H
+
+#include "kode_MAX31329.h"
+
+#include <atomic>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#ifndef MAX31329_PUBLISHER_STACK
+#define MAX31329_PUBLISHER_STACK 3072
+#endif
+
+// Reader attempts before read() gives up (only hit if the poller publishes
+// twice while one read is in progress)
+#ifndef MAX31329_PUBLISHER_TRIES
+#define MAX31329_PUBLISHER_TRIES 8
+#endif
+
+// One published poll result
+struct MAX31329_PublishedTime {
+	int64_t epochMs;      // RTC time of the last good read
+	int64_t capturedUs;   // local time at the middle of that read
+	uint32_t errorMs;     // error bound reported by readEpochMs()
+	uint32_t sequence;    // publish() calls so far
+	uint32_t failures;    // consecutive failed polls (time is stale when > 0)
+	uint8_t status;       // STATUS read by the latest poll (setPollStatus)
+	uint8_t lastFlags;    // most recent non-zero STATUS ...
+	uint32_t lastFlagsSeq; // ... and the sequence that saw it
+	bool trimmed;         // software trim was active
+};
+
+// Shares one MAX31329 between tasks on both cores. A single poller (the
+// task from start(), or whoever calls publish()) owns the bus and
+// publishes each result into one of two seqlock-protected slots; readers
+// copy the other, settled slot with plain atomic loads. Readers never take
+// a lock, never touch I2C or rtc.t, and are safe from any task or core.
+// A poller preempted mid-write does not block them.
+class MAX31329_Publisher {
+public:
+	explicit MAX31329_Publisher(MAX31329 &rtc);
+	~MAX31329_Publisher();
+
+	// Also read STATUS on every poll. Reading clears the flags, so leave
+	// this off when MAX31329_Events or another consumer owns STATUS.
+	void setPollStatus(bool enable) { pollStatus = enable; }
+	void setMicrosSource(MAX31329_MicrosFn fn);
+
+	// Poller side: one bus read and one publish. Not reentrant.
+	bool publish();
+	// Spawn the poller task (no-op on host builds; call publish() instead).
+	// core -1 leaves it unpinned.
+	bool start(uint32_t periodMs, uint8_t priority = 5, int core = -1);
+	void stop();
+
+	// Reader side: false before the first good publish
+	bool read(MAX31329_PublishedTime &out) const;
+	// Published time carried forward with the local clock
+	bool readEpochMs(int64_t &epochMs) const;
+	bool readTime(MAX31329_Time &t) const;
+	uint32_t readerRetries() const { return retries.load(std::memory_order_relaxed); }
+
+private:
+	static const uint8_t WORDS = 9;
+	struct Slot {
+		std::atomic<uint32_t> seq;
+		std::atomic<uint32_t> w[WORDS];
+	};
+
+	MAX31329 &rtc;
+	MAX31329_MicrosFn microsFn;
+	bool pollStatus;
+	Slot slots[2];
+	std::atomic<uint32_t> current; // stores so far; the low bit is the slot readers copy
+	mutable std::atomic<uint32_t> retries;
+	MAX31329_PublishedTime last; // poller-owned
+	bool haveTime;
+
+	void store(const MAX31329_PublishedTime &p);
+
+#if defined(ARDUINO_ARCH_ESP32)
+	TaskHandle_t volatile task;
+	volatile bool running;
+	uint32_t periodMs;
+	static void taskMain(void *arg);
+#endif
+};
+
+#endif // KODE_MAX31329_PUBLISHER_H
@@ -56,6 +56,7 @@
 #define MAX31329_STATUS_A2F_POS              1
 #define MAX31329_STATUS_TIF_POS              2
 #define MAX31329_STATUS_DIF_POS              3
+#define MAX31329_STATUS_LOS_POS              4
 #define MAX31329_STATUS_PFAIL_POS            5
 #define MAX31329_STATUS_OSF_POS              6
 #define MAX31329_STATUS_PSDECT_POS           7
@@ -64,6 +65,7 @@
 #define MAX31329_STATUS_A2F                  (1u << MAX31329_STATUS_A2F_POS)
 #define MAX31329_STATUS_TIF                  (1u << MAX31329_STATUS_TIF_POS)
 #define MAX31329_STATUS_DIF                  (1u << MAX31329_STATUS_DIF_POS)
+#define MAX31329_STATUS_LOS                  (1u << MAX31329_STATUS_LOS_POS)
 #define MAX31329_STATUS_PFAIL                (1u << MAX31329_STATUS_PFAIL_POS)
 #define MAX31329_STATUS_OSF                  (1u << MAX31329_STATUS_OSF_POS)
 #define MAX31329_STATUS_PSDECT               (1u << MAX31329_STATUS_PSDECT_POS)
@@ -108,6 +110,16 @@
 #define MAX31329_TMR_TPAUSE                  (1u << 3)
 #define MAX31329_TMR_TE                      (1u << 4)
 
+// Time register bits
+#define MAX31329_HOURS_F_24_12               (1u << 6) // 12-hour format
+#define MAX31329_HOURS_AM_PM                 (1u << 5) // PM in 12-hour format, HR_20 in 24-hour
+#define MAX31329_MONTH_CENTURY               (1u << 7) // year 21xx
+
+// Alarm register bits
+#define MAX31329_ALM_MASK                    (1u << 7) // AxMn mask bit, every alarm register
+#define MAX31329_ALM_DY_DT                   (1u << 6) // ALMx_DAY_DATE: match day of week
+#define MAX31329_ALM1_MON_A1M6               (1u << 6) // ALM1_MON: year mask
+
 // PWR_MGMT bits
 #define MAX31329_PWR_DMAN_SEL                (1u << 0)
 #define MAX31329_PWR_D_VBACK_SEL             (1u << 1)
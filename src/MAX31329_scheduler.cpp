@@ -0,0 +1,211 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_scheduler.h"
+
+static_assert(MAX31329_SCHEDULER_MAX_JOBS < 256, "job slots and the job count are uint8_t");
+
+// Countdown timer frequencies by TFS value
+static const uint16_t timerHz[4] = {1024, 256, 64, 16};
+
+MAX31329_Scheduler::MAX31329_Scheduler(MAX31329 &r)
+	: rtc(r), jobs(), heap(), pos(), count(0), tolerance(0),
+	  armedKind(ARM_NONE), armedFor(0), source(ARM_NONE) {}
+
+int MAX31329_Scheduler::add(int64_t deadlineMs, MAX31329_JobFn fn, void *arg, uint32_t periodMs) {
+	if (!fn || count >= MAX31329_SCHEDULER_MAX_JOBS) return -1;
+	uint8_t slot = 0;
+	while (jobs[slot].used) ++slot;
+	Job &j = jobs[slot];
+	j.deadline = deadlineMs;
+	j.fn = fn;
+	j.arg = arg;
+	j.period = periodMs;
+	j.used = true;
+	push(slot);
+	// Generation in the upper bits keeps stale ids from cancelling a reused slot
+	return (int)(((uint32_t)j.generation << 8) | slot);
+}
+
+bool MAX31329_Scheduler::cancel(int id) {
+	if (id < 0) return false;
+	uint8_t slot = (uint8_t)(id & 0xFF);
+	if (slot >= MAX31329_SCHEDULER_MAX_JOBS) return false;
+	Job &j = jobs[slot];
+	if (!j.used || j.generation != (uint8_t)(id >> 8)) return false;
+	removeAt(pos[slot]);
+	j.used = false;
+	j.generation++;
+	return true;
+}
+
+void MAX31329_Scheduler::clear() {
+	for (uint8_t i = 0; i < count; ++i) {
+		Job &j = jobs[heap[i]];
+		j.used = false;
+		j.generation++;
+	}
+	count = 0;
+}
+
+void MAX31329_Scheduler::setTolerance(uint32_t toleranceMs) {
+	tolerance = toleranceMs;
+}
+
+size_t MAX31329_Scheduler::pending() const {
+	return count;
+}
+
+bool MAX31329_Scheduler::nextDeadline(int64_t &deadlineMs) const {
+	if (count == 0) return false;
+	deadlineMs = jobs[heap[0]].deadline;
+	return true;
+}
+
+bool MAX31329_Scheduler::arm() {
+	int64_t now;
+	if (!rtc.readEpochMs(now)) return false;
+	return armAt(now);
+}
+
+int MAX31329_Scheduler::service() {
+	int64_t now;
+	if (!rtc.readEpochMs(now)) return -1;
+	int ran = 0;
+	while (count > 0 && jobs[heap[0]].deadline <= now + (int64_t)tolerance) {
+		uint8_t slot = heap[0];
+		Job &j = jobs[slot];
+		MAX31329_JobFn fn = j.fn;
+		void *arg = j.arg;
+		// Reschedule (or retire) before the call so the callback may cancel
+		// or add jobs freely
+		if (j.period) {
+			int64_t missed = (now - j.deadline) / (int64_t)j.period;
+			j.deadline += (missed + 1) * (int64_t)j.period;
+			siftDown(0);
+		} else {
+			removeAt(0);
+			j.used = false;
+			j.generation++;
+		}
+		fn(arg);
+		ran++;
+	}
+	// A hardware alarm that has fired is no longer armed
+	armedKind = ARM_NONE;
+	if (!rtc.readEpochMs(now)) return -1;
+	return armAt(now) ? ran : -1;
+}
+
+bool MAX31329_Scheduler::armAt(int64_t now) {
+	if (count == 0) return true;
+	int64_t target = jobs[heap[0]].deadline;
+	int64_t delta = target - now;
+	if (delta <= 0) delta = 1;
+
+	// Fastest countdown frequency whose 8-bit range still reaches the target
+	for (uint8_t fs = 0; fs < 4; ++fs) {
+		int64_t ticks = (delta * timerHz[fs] + 999) / 1000;
+		if (ticks > 255) continue;
+		if (armedKind == ARM_TIMER && armedFor == target) return true;
+		// Timer setup, the restart and, coming from Alarm1, the swap of the
+		// interrupt enables in one commit, so a stale Alarm1 cannot fire
+		MAX31329_Transaction tx;
+		if (source != ARM_TIMER) {
+			tx.disableInterrupts(MAX31329_INT_A1IE);
+			tx.enableInterrupts(MAX31329_INT_TIE);
+		}
+		tx.timerConfigure((uint8_t)(ticks ? ticks : 1), false, fs);
+		tx.timerStart();
+		if (!rtc.commit(tx)) return false;
+		source = ARM_TIMER;
+		armedKind = ARM_TIMER;
+		armedFor = target;
+		return true;
+	}
+
+	if (armedKind == ARM_ALARM && armedFor == target) return true;
+	// Alarm1 matches raw RTC time at second resolution: undo the drift trim
+	// and round up so jobs never run early
+	int64_t rtcUs = rtc.untrimUs(target * 1000);
+	MAX31329_Time t;
+	MAX31329::epochToTime((rtcUs + 999999) / 1000000, t);
+	MAX31329_Alarm1 alarm = MAX31329_Alarm1::once((uint16_t)t.year, (uint8_t)t.month, (uint8_t)t.day,
+		(uint8_t)t.hour, (uint8_t)t.minute, (uint8_t)t.second);
+	if (!rtc.setAlarm1(alarm)) return false;
+	if (source != ARM_ALARM) {
+		// Coming from the timer: stop it and swap the enables in one commit
+		MAX31329_Transaction tx;
+		tx.timerStop();
+		tx.disableInterrupts(MAX31329_INT_TIE);
+		tx.enableInterrupts(MAX31329_INT_A1IE);
+		if (!rtc.commit(tx)) return false;
+		source = ARM_ALARM;
+	}
+	armedKind = ARM_ALARM;
+	armedFor = target;
+	return true;
+}
+
+bool MAX31329_Scheduler::less(uint8_t a, uint8_t b) const {
+	return jobs[heap[a]].deadline < jobs[heap[b]].deadline;
+}
+
+void MAX31329_Scheduler::swap(uint8_t i, uint8_t j) {
+	uint8_t t = heap[i];
+	heap[i] = heap[j];
+	heap[j] = t;
+	pos[heap[i]] = i;
+	pos[heap[j]] = j;
+}
+
+void MAX31329_Scheduler::siftUp(uint8_t i) {
+	while (i > 0) {
+		uint8_t parent = (uint8_t)((i - 1) / 2);
+		if (!less(i, parent)) break;
+		swap(i, parent);
+		i = parent;
+	}
+}
+
+void MAX31329_Scheduler::siftDown(uint8_t i) {
+	for (;;) {
+		uint16_t l = (uint16_t)(2 * i + 1);
+		uint16_t r = (uint16_t)(l + 1);
+		uint8_t m = i;
+		if (l < count && less((uint8_t)l, m)) m = (uint8_t)l;
+		if (r < count && less((uint8_t)r, m)) m = (uint8_t)r;
+		if (m == i) return;
+		swap(i, m);
+		i = m;
+	}
+}
+
+void MAX31329_Scheduler::push(uint8_t slot) {
+	uint8_t i = count++;
+	heap[i] = slot;
+	pos[slot] = i;
+	siftUp(i);
+}
+
+void MAX31329_Scheduler::removeAt(uint8_t i) {
+	uint8_t last = (uint8_t)(--count);
+	if (i != last) {
+		swap(i, last);
+		siftDown(i);
+		siftUp(i);
+	}
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_SCHEDULER_H
+#define KODE_MAX31329_SCHEDULER_H
+
+#include "kode_MAX31329.h"
+
+// Maximum number of pending jobs per scheduler (at most 255)
+#ifndef MAX31329_SCHEDULER_MAX_JOBS
+#define MAX31329_SCHEDULER_MAX_JOBS 32
+#endif
+
+typedef void (*MAX31329_JobFn)(void *arg);
+
+// Software deadlines multiplexed onto Alarm1 and the countdown timer.
+// Jobs live in a fixed-size min-heap keyed by deadline (epoch milliseconds,
+// the readEpochMs() timebase). The hardware is always armed for the nearest
+// deadline: the countdown timer when it is close enough for sub-second
+// resolution (< ~15 s), otherwise Alarm1 with a full date match. Call
+// service() when the RTC interrupt fires (A1F or TIF); it runs every job
+// due within the coalescing tolerance and rearms.
+// The scheduler owns Alarm1, the countdown timer and their interrupt enables;
+// only the source armed for the nearest deadline is left enabled.
+class MAX31329_Scheduler {
+public:
+	explicit MAX31329_Scheduler(MAX31329 &rtc);
+
+	// Schedule fn at deadlineMs, repeating every periodMs if non-zero.
+	// Returns a job id, or -1 when the scheduler is full.
+	int add(int64_t deadlineMs, MAX31329_JobFn fn, void *arg = nullptr, uint32_t periodMs = 0);
+	bool cancel(int id);
+	void clear();
+
+	// Jobs due up to toleranceMs from now run in the same wake
+	void setTolerance(uint32_t toleranceMs);
+
+	size_t pending() const;
+	bool nextDeadline(int64_t &deadlineMs) const;
+
+	// Program the hardware for the nearest deadline (no bus traffic when it
+	// is already armed for it)
+	bool arm();
+	// Run due jobs and rearm; returns the number of jobs run or -1 on bus error
+	int service();
+
+private:
+	struct Job {
+		int64_t deadline;
+		MAX31329_JobFn fn;
+		void *arg;
+		uint32_t period;
+		uint8_t generation;
+		bool used;
+	};
+
+	enum ArmKind : uint8_t { ARM_NONE, ARM_ALARM, ARM_TIMER };
+
+	MAX31329 &rtc;
+	Job jobs[MAX31329_SCHEDULER_MAX_JOBS];
+	uint8_t heap[MAX31329_SCHEDULER_MAX_JOBS]; // job slots ordered by deadline
+	uint8_t pos[MAX31329_SCHEDULER_MAX_JOBS];  // heap index of each slot
+	uint8_t count;
+	uint32_t tolerance;
+	ArmKind armedKind;
+	int64_t armedFor;
+	ArmKind source;  // interrupt source enabled; the other one is off
+
+	bool less(uint8_t a, uint8_t b) const;
+	void swap(uint8_t i, uint8_t j);
+	void siftUp(uint8_t i);
+	void siftDown(uint8_t i);
+	void push(uint8_t slot);
+	void removeAt(uint8_t i);
+	bool armAt(int64_t now);
+};
+
+#endif // KODE_MAX31329_SCHEDULER_H
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_STATS_H
+#define KODE_MAX31329_STATS_H
+
+#include <stdint.h>
+
+// Build with -DKODE_MAX31329_STATS=1 to record I2C usage per API call.
+// When 0 (default) no counters exist and the hooks compile away.
+#ifndef KODE_MAX31329_STATS
+#define KODE_MAX31329_STATS 0
+#endif
+
+// Latency histogram buckets: bucket i counts calls faster than (64us << i),
+// the last bucket counts everything slower.
+#define MAX31329_STATS_BUCKETS               8
+#define MAX31329_STATS_BUCKET0_US            64u
+
+// Public API calls that get their own counters. Direct readBytes()/writeBytes()
+// use from user code lands in MAX31329_OP_OTHER.
+enum MAX31329_Op : uint8_t {
+	MAX31329_OP_OTHER = 0,
+	MAX31329_OP_BEGIN,
+	MAX31329_OP_IS_CONNECTED,
+	MAX31329_OP_READ_TIME,
+	MAX31329_OP_WRITE_TIME,
+	MAX31329_OP_READ_STATUS,
+	MAX31329_OP_CLEAR_STATUS,
+	MAX31329_OP_ENABLE_INTERRUPTS,
+	MAX31329_OP_DISABLE_INTERRUPTS,
+	MAX31329_OP_SET_ALARM,
+	MAX31329_OP_READ_ALARM,
+	MAX31329_OP_START_RTC,
+	MAX31329_OP_STOP_RTC,
+	MAX31329_OP_ASSERT_RESET,
+	MAX31329_OP_RELEASE_RESET,
+	MAX31329_OP_CLKO_ENABLE,
+	MAX31329_OP_CLKO_DISABLE,
+	MAX31329_OP_CLKIN_DISABLE,
+	MAX31329_OP_TIMER_CONFIGURE,
+	MAX31329_OP_TIMER_START,
+	MAX31329_OP_TIMER_PAUSE,
+	MAX31329_OP_TIMER_CONTINUE,
+	MAX31329_OP_TIMER_STOP,
+	MAX31329_OP_TIMER_READ,
+	MAX31329_OP_SET_POWER_FAIL_THRESHOLD,
+	MAX31329_OP_SELECT_SUPPLY,
+	MAX31329_OP_TRICKLE_ENABLE,
+	MAX31329_OP_TRICKLE_DISABLE,
+	MAX31329_OP_SHADOW_RESYNC,
+	MAX31329_OP_COMMIT,
+	MAX31329_OP_READ_RAM,
+	MAX31329_OP_WRITE_RAM,
+	MAX31329_OP_SNAPSHOT,
+	MAX31329_OP_COUNT
+};
+
+struct MAX31329_OpStats {
+	uint32_t calls = 0;
+	uint32_t transactions = 0;  // I2C transactions issued
+	uint32_t bytes = 0;         // register pointer + payload bytes on the bus
+	uint32_t failures = 0;      // failed transactions
+	uint32_t latency[MAX31329_STATS_BUCKETS] = {}; // per-call latency histogram
+};
+
+struct MAX31329_Stats {
+	MAX31329_OpStats ops[MAX31329_OP_COUNT];
+};
+
+#endif // KODE_MAX31329_STATS_H
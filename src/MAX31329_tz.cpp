@@ -0,0 +1,260 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MAX31329_tz.h"
+
+#include <time.h>
+
+// 2000-01-01 00:00:00 UTC
+static const int64_t TZ_BASE = 946684800;
+
+MAX31329_TimeZone::MAX31329_TimeZone()
+	: stdOffset(0), dstOffset(0), firstIsStart(true), count(0), table() {}
+
+const char *MAX31329_TimeZone::parseName(const char *p) {
+	const char *s = p;
+	if (*p == '<') {
+		while (*p && *p != '>') ++p;
+		if (*p != '>' || p - s < 4) return nullptr;
+		return p + 1;
+	}
+	while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) ++p;
+	return (p - s >= 3) ? p : nullptr;
+}
+
+const char *MAX31329_TimeZone::parseOffset(const char *p, int32_t &seconds) {
+	int sign = 1;
+	if (*p == '+' || *p == '-') sign = (*p++ == '-') ? -1 : 1;
+	int32_t parts[3] = {0, 0, 0};
+	for (uint8_t i = 0; i < 3; ++i) {
+		if (*p < '0' || *p > '9') return nullptr;
+		int32_t v = 0;
+		while (*p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+		parts[i] = v;
+		if (*p != ':') break;
+		++p;
+	}
+	if (parts[0] > 167 || parts[1] > 59 || parts[2] > 59) return nullptr;
+	seconds = sign * (parts[0] * 3600 + parts[1] * 60 + parts[2]);
+	return p;
+}
+
+const char *MAX31329_TimeZone::parseRule(const char *p, Rule &r) {
+	r.time = 7200;
+	r.month = 0;
+	r.week = 0;
+	if (*p == 'M') {
+		int v[3] = {0, 0, 0};
+		++p;
+		for (uint8_t i = 0; i < 3; ++i) {
+			if (*p < '0' || *p > '9') return nullptr;
+			while (*p >= '0' && *p <= '9') v[i] = v[i] * 10 + (*p++ - '0');
+			if (i < 2 && *p++ != '.') return nullptr;
+		}
+		if (v[0] < 1 || v[0] > 12 || v[1] < 1 || v[1] > 5 || v[2] > 6) return nullptr;
+		r.kind = 'M';
+		r.month = (uint8_t)v[0];
+		r.week = (uint8_t)v[1];
+		r.day = (uint16_t)v[2];
+	} else {
+		r.kind = 'D';
+		if (*p == 'J') {
+			r.kind = 'J';
+			++p;
+		}
+		if (*p < '0' || *p > '9') return nullptr;
+		int v = 0;
+		while (*p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+		if (r.kind == 'J' ? (v < 1 || v > 365) : v > 365) return nullptr;
+		r.day = (uint16_t)v;
+	}
+	if (*p == '/') p = parseOffset(p + 1, r.time);
+	return p;
+}
+
+// Local (wall clock, offset not applied) epoch seconds of the rule in year
+int64_t MAX31329_TimeZone::ruleToLocal(const Rule &r, int year) {
+	int64_t jan1 = MAX31329::daysFromCivil(year, 1, 1);
+	int64_t day;
+	if (r.kind == 'J') {
+		day = jan1 + r.day - 1;
+		if (MAX31329::daysInMonth(year, 2) == 29 && r.day >= 60) ++day;
+	} else if (r.kind == 'D') {
+		day = jan1 + r.day;
+	} else {
+		int64_t first = MAX31329::daysFromCivil(year, r.month, 1);
+		int wday = (int)((first % 7 + 11) % 7); // 1970-01-01 was a Thursday
+		day = first + (r.day - wday + 7) % 7 + (r.week - 1) * 7;
+		int len = MAX31329::daysInMonth(year, r.month);
+		while (day >= first + len) day -= 7;
+	}
+	return day * 86400 + r.time;
+}
+
+bool MAX31329_TimeZone::setRules(const char *tz) {
+	stdOffset = dstOffset = 0;
+	firstIsStart = true;
+	count = 0;
+	if (!tz) return false;
+
+	const char *p = parseName(tz);
+	int32_t off;
+	if (!p || !(p = parseOffset(p, off))) return false;
+	int32_t stdOff = -off; // POSIX offsets count west of Greenwich
+	if (!*p) {
+		stdOffset = dstOffset = stdOff;
+		return true;
+	}
+	if (!(p = parseName(p))) return false;
+	int32_t dstOff = stdOff + 3600;
+	if (*p && *p != ',') {
+		if (!(p = parseOffset(p, off))) return false;
+		dstOff = -off;
+	}
+	Rule start, end;
+	if (!*p) {
+		// No rules given: the POSIX default (current US rules)
+		p = ",M3.2.0,M11.1.0";
+	}
+	if (*p++ != ',' || !(p = parseRule(p, start)) || *p++ != ',' ||
+		!(p = parseRule(p, end)) || *p) {
+		return false;
+	}
+
+	stdOffset = stdOff;
+	dstOffset = dstOff;
+	for (int y = MAX31329_TZ_FIRST_YEAR; y <= MAX31329_TZ_LAST_YEAR; ++y) {
+		// The start rule is in standard time, the end rule in daylight time
+		int64_t on = ruleToLocal(start, y) - stdOff - TZ_BASE;
+		int64_t offT = ruleToLocal(end, y) - dstOff - TZ_BASE;
+		bool startFirst = on <= offT;
+		if (y == MAX31329_TZ_FIRST_YEAR) firstIsStart = startFirst;
+		int64_t a = startFirst ? on : offT;
+		int64_t b = startFirst ? offT : on;
+		a = a < 0 ? 0 : MAX31329::floorDiv(a, 60);
+		b = b < 0 ? 0 : MAX31329::floorDiv(b, 60);
+		table[count++] = (uint32_t)a;
+		table[count++] = (uint32_t)b;
+	}
+	return true;
+}
+
+bool MAX31329_TimeZone::dstAt(int64_t utcEpoch) const {
+	if (!count) return false;
+	int64_t m = MAX31329::floorDiv(utcEpoch - TZ_BASE, 60);
+	// Number of transitions at or before m (upper bound)
+	uint16_t lo = 0, hi = count;
+	if (m < 0) {
+		hi = 0;
+	} else {
+		while (lo < hi) {
+			uint16_t mid = (uint16_t)((lo + hi) / 2);
+			if ((int64_t)table[mid] <= m) lo = (uint16_t)(mid + 1);
+			else hi = mid;
+		}
+	}
+	bool odd = (hi & 1) != 0;
+	return firstIsStart ? odd : !odd;
+}
+
+int32_t MAX31329_TimeZone::offsetAt(int64_t utcEpoch, bool *isDst) const {
+	bool dst = dstAt(utcEpoch);
+	if (isDst) *isDst = dst;
+	return dst ? dstOffset : stdOffset;
+}
+
+void MAX31329_TimeZone::toLocal(int64_t utcEpoch, MAX31329_Time &local, bool *isDst) const {
+	MAX31329::epochToTime(toLocal(utcEpoch, isDst), local);
+}
+
+void MAX31329_TimeZone::toLocal(int64_t utcEpoch, struct tm &local) const {
+	bool dst;
+	MAX31329_Time t;
+	toLocal(utcEpoch, t, &dst);
+	t.toTm(local);
+	local.tm_isdst = dst ? 1 : 0;
+}
+
+bool MAX31329_TimeZone::toUtc(int64_t localEpoch, int64_t &utcEpoch, int8_t isDst) const {
+	int64_t asDst = localEpoch - dstOffset;
+	int64_t asStd = localEpoch - stdOffset;
+	bool dstOk = count && dstAt(asDst);
+	bool stdOk = !dstAt(asStd);
+	if (dstOk && stdOk && asDst != asStd) {
+		utcEpoch = (isDst == 0) ? asStd : asDst;
+		return true;
+	}
+	if (dstOk) {
+		utcEpoch = asDst;
+		return true;
+	}
+	// Standard time, or the gap: read with the offset before the jump
+	utcEpoch = asStd;
+	return stdOk;
+}
+
+bool MAX31329_TimeZone::toUtc(const MAX31329_Time &local, int64_t &utcEpoch, int8_t isDst) const {
+	return toUtc(MAX31329::timeToEpoch(local), utcEpoch, isDst);
+}
+
+int64_t MAX31329_TimeZone::nextDaily(int64_t utcNow, uint8_t hour, uint8_t minute,
+	uint8_t second) const {
+	int64_t tod = (int64_t)hour * 3600 + minute * 60 + second;
+	int64_t day = MAX31329::floorDiv(toLocal(utcNow), 86400);
+	for (uint8_t i = 0; i < 3; ++i, ++day) {
+		int64_t utc;
+		toUtc(day * 86400 + tod, utc);
+		if (utc > utcNow) return utc;
+	}
+	return utcNow + 86400;
+}
+
+bool MAX31329_TimeZone::readLocal(MAX31329 &rtc, MAX31329_Time &local, bool *isDst) const {
+	int64_t ms;
+	if (!rtc.readEpochMs(ms)) return false;
+	int64_t sec = MAX31329::floorDiv(ms, 1000);
+	toLocal(sec, local, isDst);
+	local.millisecond = (int)(ms - sec * 1000);
+	return true;
+}
+
+bool MAX31329_TimeZone::writeLocal(MAX31329 &rtc, const MAX31329_Time &local, int8_t isDst) const {
+	int64_t utc;
+	toUtc(local, utc, isDst);
+	return rtc.writeEpoch(utc);
+}
+
+bool MAX31329_TimeZone::setAlarmLocal(MAX31329 &rtc, const MAX31329_Time &local, int8_t isDst) const {
+	int64_t utc;
+	toUtc(local, utc, isDst);
+	MAX31329_Time u;
+	MAX31329::epochToTime(utc, u);
+	MAX31329_Alarm1 a = MAX31329_Alarm1::once((uint16_t)u.year, (uint8_t)u.month, (uint8_t)u.day,
+		(uint8_t)u.hour, (uint8_t)u.minute, (uint8_t)u.second);
+	return a.valid() && rtc.setAlarm1(a);
+}
+
+bool MAX31329_TimeZone::armDailyLocal(MAX31329 &rtc, uint8_t hour, uint8_t minute,
+	uint8_t second) const {
+	if (hour > 23 || minute > 59 || second > 59) return false;
+	int64_t now;
+	if (!rtc.readEpoch(now)) return false;
+	MAX31329_Time u;
+	MAX31329::epochToTime(nextDaily(now, hour, minute, second), u);
+	MAX31329_Alarm1 a = MAX31329_Alarm1::once((uint16_t)u.year, (uint8_t)u.month, (uint8_t)u.day,
+		(uint8_t)u.hour, (uint8_t)u.minute, (uint8_t)u.second);
+	return a.valid() && rtc.setAlarm1(a);
+}
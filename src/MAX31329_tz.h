@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 KODE DIY, SOCIEDAD LIMITADA
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KODE_MAX31329_TZ_H
+#define KODE_MAX31329_TZ_H
+
+#include "kode_MAX31329.h"
+
+// Years covered by the transition table (the RTC range is 2000-2199)
+#ifndef MAX31329_TZ_FIRST_YEAR
+#define MAX31329_TZ_FIRST_YEAR 2000
+#endif
+#ifndef MAX31329_TZ_LAST_YEAR
+#define MAX31329_TZ_LAST_YEAR 2199
+#endif
+#define MAX31329_TZ_MAX_TRANSITIONS (2 * (MAX31329_TZ_LAST_YEAR - MAX31329_TZ_FIRST_YEAR + 1))
+
+// Local time from a POSIX TZ string ("CET-1CEST,M3.5.0,M10.5.0/3").
+// setRules() parses the string once and expands every DST transition in
+// the covered years into a sorted table (uint32 minutes since 2000-01-01
+// UTC, 1.6 KB for 2000-2199); conversions are then a binary search with
+// no libc TZ state. Transitions are kept to the minute.
+//
+// The intended policy is UTC on the chip: writeLocal() stores UTC,
+// readLocal() converts on the way out, and local-time alarms are converted
+// to an absolute UTC Alarm1, so a DST change never leaves the chip an hour off.
+class MAX31329_TimeZone {
+public:
+	MAX31329_TimeZone();
+
+	// false (and the zone left at UTC) when the string does not parse
+	bool setRules(const char *posixTz);
+	bool hasDst() const { return count > 0; }
+	uint16_t transitions() const { return count; }
+
+	// UTC offset in seconds (east positive) in effect at utcEpoch
+	int32_t offsetAt(int64_t utcEpoch, bool *isDst = nullptr) const;
+	int64_t toLocal(int64_t utcEpoch, bool *isDst = nullptr) const { return utcEpoch + offsetAt(utcEpoch, isDst); }
+	void toLocal(int64_t utcEpoch, MAX31329_Time &local, bool *isDst = nullptr) const;
+	void toLocal(int64_t utcEpoch, struct tm &local) const; // sets tm_isdst
+	// Local wall time to UTC. isDst picks the side of a repeated hour
+	// (-1: the first occurrence). Returns false for a time inside the
+	// spring-forward gap; utcEpoch is then shifted forward past it.
+	bool toUtc(int64_t localEpoch, int64_t &utcEpoch, int8_t isDst = -1) const;
+	bool toUtc(const MAX31329_Time &local, int64_t &utcEpoch, int8_t isDst = -1) const;
+
+	// Next UTC instant after utcNow whose local wall time is hh:mm:ss. On a
+	// day where that time falls in the gap, the shifted instant is used.
+	int64_t nextDaily(int64_t utcNow, uint8_t hour, uint8_t minute, uint8_t second) const;
+
+	// UTC-on-chip helpers
+	bool readLocal(MAX31329 &rtc, MAX31329_Time &local, bool *isDst = nullptr) const;
+	bool writeLocal(MAX31329 &rtc, const MAX31329_Time &local, int8_t isDst = -1) const;
+	// One-shot Alarm1 at a local date and time, stored as its UTC instant
+	bool setAlarmLocal(MAX31329 &rtc, const MAX31329_Time &local, int8_t isDst = -1) const;
+	// Alarm1 at the next local hh:mm:ss; call again after each match to re-arm
+	bool armDailyLocal(MAX31329 &rtc, uint8_t hour, uint8_t minute, uint8_t second) const;
+
+private:
+	int32_t stdOffset;  // seconds east of UTC
+	int32_t dstOffset;
+	bool firstIsStart;  // the earliest transition enters DST
+	uint16_t count;
+	uint32_t table[MAX31329_TZ_MAX_TRANSITIONS];
+
+	struct Rule {
+		uint8_t kind;    // 'J' (1-365, no Feb 29), 'D' (0-365) or 'M'
+		uint16_t day;    // J/D day, or M day of week
+		uint8_t month;
+		uint8_t week;
+		int32_t time;    // seconds after local midnight
+	};
+
+	bool dstAt(int64_t utcEpoch) const;
+	static int64_t ruleToLocal(const Rule &r, int year);
+	static const char *parseName(const char *p);
+	static const char *parseOffset(const char *p, int32_t &seconds);
+	static const char *parseRule(const char *p, Rule &r);
+};
+
+#endif // KODE_MAX31329_TZ_H
@@ -16,31 +16,78 @@
 
 #include "kode_MAX31329.h"
 
-static inline bool i2cWriteThenRead(TwoWire &w, uint8_t addr, uint8_t reg, uint8_t *buffer, size_t length) {
-	w.beginTransmission(addr);
-	w.write(reg);
-	if (w.endTransmission(false) != 0) {
-		return false;
-	}
-	uint8_t read = w.requestFrom((int)addr, (int)length, (int)true);
-	if (read != length) {
-		return false;
-	}
-	for (size_t i = 0; i < length; ++i) {
-		buffer[i] = w.read();
-	}
-	return true;
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+#if KODE_MAX31329_STATS
+#define MAX31329_TRACE(op) StatsScope statsScope_(*this, op)
+#else
+#define MAX31329_TRACE(op) do {} while (0)
+#endif
+
+static int64_t defaultMicros() {
+#if defined(ARDUINO_ARCH_ESP32)
+	return esp_timer_get_time();
+#else
+	return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant)
+int32_t MAX31329::daysFromCivil(int y, unsigned m, unsigned d) {
+	y -= m <= 2;
+	const int era = (y >= 0 ? y : y - 399) / 400;
+	const unsigned yoe = (unsigned)(y - era * 400);
+	const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + (int32_t)doe - 719468;
+}
+
+static void civilFromDays(int32_t z, int &y, unsigned &m, unsigned &d) {
+	z += 719468;
+	const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+	const unsigned doe = (unsigned)(z - era * 146097);
+	const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const unsigned mp = (5 * doy + 2) / 153;
+	d = doy - (153 * mp + 2) / 5 + 1;
+	m = mp < 10 ? mp + 3 : mp - 9;
+	y = (int)yoe + era * 400 + (m <= 2);
+}
+
+int64_t MAX31329::floorDiv(int64_t a, int64_t b) {
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+uint8_t MAX31329::daysInMonth(int y, unsigned m) {
+	static const uint8_t len[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+	if (m < 1 || m > 12) return 0;
+	bool leap = ((y & 3) == 0 && (y % 100 != 0 || y % 400 == 0));
+	return (uint8_t)(len[m - 1] + ((leap && m == 2) ? 1 : 0));
 }
 
-static inline bool i2cWriteBytes(TwoWire &w, uint8_t addr, uint8_t reg, const uint8_t *buffer, size_t length) {
-	w.beginTransmission(addr);
-	w.write(reg);
-	w.write(buffer, length);
-	return (w.endTransmission() == 0);
+// 0-based day of the year; -1 for a month outside 1..12 (a caller's bad
+// MAX31329_Time or a corrupt MONTH register)
+static int dayOfYear(int y, int m, int d) {
+	static const uint16_t cumDays[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+	if (m < 1 || m > 12) return -1;
+	bool leap = ((y & 3) == 0 && (y % 100 != 0 || y % 400 == 0));
+	return cumDays[m - 1] + d - 1 + ((leap && m > 2) ? 1 : 0);
 }
 
 uint8_t MAX31329::binToBcd(uint8_t v) { return (uint8_t)(((v / 10) << 4) | (v % 10)); }
-uint8_t MAX31329::bcdToBin(uint8_t v) { return (uint8_t)(((v >> 4) * 10) + (v & 0x0F)); }
+uint8_t MAX31329::bcdToBin(uint8_t v) { return (uint8_t)(v - 6 * (v >> 4)); }
+
+int64_t MAX31329::regsToEpoch(const uint8_t *regs) {
+	int year = 2000 + bcdToBin(regs[6]) + ((regs[5] & 0x80) ? 100 : 0);
+	int32_t days = daysFromCivil(year, bcdToBin(regs[5] & 0x1F), bcdToBin(regs[4] & 0x3F));
+	return (int64_t)days * 86400 + bcdToBin(regs[2] & 0x3F) * 3600 +
+		bcdToBin(regs[1] & 0x7F) * 60 + bcdToBin(regs[0] & 0x7F);
+}
 
 void MAX31329_Time::toTm(struct tm &tm) const {
 	tm.tm_year = year - 1900;  // tm_year is years since 1900
@@ -50,7 +97,7 @@ void MAX31329_Time::toTm(struct tm &tm) const {
 	tm.tm_min = minute;
 	tm.tm_sec = second;
 	tm.tm_wday = dayOfWeek;
-	tm.tm_yday = 0;
+	tm.tm_yday = dayOfYear(year, month, day);
 	tm.tm_isdst = 0;
 }
 
@@ -64,9 +111,71 @@ void MAX31329_Time::fromTm(const struct tm &tm) {
 	dayOfWeek = tm.tm_wday;
 }
 
+bool MAX31329::epochToRegs(int64_t epoch, uint8_t *regs) {
+	int32_t days = (int32_t)floorDiv(epoch, 86400);
+	int32_t secs = (int32_t)(epoch - (int64_t)days * 86400);
+	int y; unsigned m, d;
+	civilFromDays(days, y, m, d);
+	if (y < 2000 || y > 2199) return false;
+	regs[0] = binToBcd((uint8_t)(secs % 60));
+	regs[1] = binToBcd((uint8_t)((secs / 60) % 60));
+	regs[2] = binToBcd((uint8_t)(secs / 3600));
+	regs[3] = (uint8_t)(((days % 7 + 11) % 7) + 1); // 1970-01-01 was a Thursday; 1=Sunday
+	regs[4] = binToBcd((uint8_t)d);
+	regs[5] = (uint8_t)(binToBcd((uint8_t)m) | (y >= 2100 ? 0x80 : 0));
+	regs[6] = binToBcd((uint8_t)(y % 100));
+	return true;
+}
+
+bool MAX31329_PackedTime::fromEpoch(int64_t epoch) {
+	int64_t s = epoch - EPOCH_2000;
+	if (s < 0 || s > (int64_t)UINT32_MAX) return false;
+	seconds = (uint32_t)s;
+	return true;
+}
+
+void MAX31329_PackedTime::toTime(MAX31329_Time &t) const {
+	MAX31329::epochToTime(toEpoch(), t);
+}
+
+bool MAX31329_PackedTime::fromTime(const MAX31329_Time &t) {
+	return fromEpoch(MAX31329::timeToEpoch(t));
+}
+
+void MAX31329::epochToTime(int64_t epoch, MAX31329_Time &t) {
+	int32_t days = (int32_t)floorDiv(epoch, 86400);
+	int32_t secs = (int32_t)(epoch - (int64_t)days * 86400);
+	int y; unsigned m, d;
+	civilFromDays(days, y, m, d);
+	t.year = y;
+	t.month = (int)m;
+	t.day = (int)d;
+	t.hour = secs / 3600;
+	t.minute = (secs / 60) % 60;
+	t.second = secs % 60;
+	t.dayOfWeek = (int)((days % 7 + 11) % 7); // 1970-01-01 was a Thursday
+	t.millisecond = 0;
+}
+
+int64_t MAX31329::timeToEpoch(const MAX31329_Time &t) {
+	int64_t days = daysFromCivil(t.year, (unsigned)t.month, (unsigned)t.day);
+	return days * 86400 + t.hour * 3600 + t.minute * 60 + t.second;
+}
+
 MAX31329::MAX31329()
-	: wireBus(nullptr) {}
+	: bus(), i2cAddress(MAX31329_I2C_ADDRESS), lastErr(MAX31329_OK), retryCount(0), retryBackoffUs(0),
+	  retryDeadlineUs(0), busTimeoutMs(0), autoRecover(false), health(),
+	  shadowEnabled(false), shadowValid(0), shadowRegs()
+#if KODE_MAX31329_STATS
+	, statsOp(MAX31329_OP_OTHER)
+#endif
+	, microsFn(defaultMicros), fastEnabled(false), fastValid(false),
+	  fastResyncMs(0), fastDriftPpm(0), fastEpoch(0), fastLo(0), fastHi(0),
+	  fastSyncUs(0), fastWday(0),
+	  trimOn(false), trimAtUs(0), trimOffsetUs(0), trimPpb(0)
+{}
 
+#if MAX31329_BUS_WIRE
 bool MAX31329::begin(int sdaPin, int sclPin, uint32_t frequency) {
     return begin(Wire, sdaPin, sclPin, frequency);
 }
@@ -80,38 +189,88 @@ bool MAX31329::begin(uint32_t frequency) {
 }
 
 bool MAX31329::begin(TwoWire &wire, int sdaPin, int sclPin, uint32_t frequency) {
-    wireBus = &wire;
+    MAX31329_TRACE(MAX31329_OP_BEGIN);
     if (sdaPin >= 0 && sclPin >= 0) {
-        wireBus->begin(sdaPin, sclPin, frequency);
+        wire.begin(sdaPin, sclPin, frequency);
     } else {
-        wireBus->begin();
-        wireBus->setClock(frequency);
+        wire.begin();
+        wire.setClock(frequency);
     }
+    MAX31329_WireBus b(wire, i2cAddress);
+    b.sda = sdaPin;
+    b.scl = sclPin;
+    b.frequency = frequency;
+    return begin(b);
+}
+#endif
+
+bool MAX31329::begin(const MAX31329_Bus &b) {
+    MAX31329_TRACE(MAX31329_OP_BEGIN);
+    bus = b;
+#if MAX31329_BUS_WIRE
+    i2cAddress = bus.address;
+#endif
+    if (busTimeoutMs) bus.setTimeout(busTimeoutMs);
     uint8_t dummy;
-    return readBytes(MAX31329_REG_STATUS, &dummy, 1);
+    if (!readBytes(MAX31329_REG_STATUS, &dummy, 1)) return false;
+    return shadowEnabled ? shadowResync() : true;
+}
+
+void MAX31329::setAddress(uint8_t addr) {
+	i2cAddress = addr;
+#if MAX31329_BUS_WIRE
+	bus.address = addr;
+#endif
+	// Another device: nothing cached so far applies to it
+	shadowInvalidate();
+	fastValid = false;
 }
 
 bool MAX31329::isConnected() {
+	MAX31329_TRACE(MAX31329_OP_IS_CONNECTED);
 	uint8_t v;
 	return readBytes(MAX31329_REG_STATUS, &v, 1);
 }
 
 bool MAX31329::readTime() {
+	MAX31329_TRACE(MAX31329_OP_READ_TIME);
 	struct tm tm;
+	if (fastEnabled || trimOn) {
+		int64_t ms;
+		if (!readEpochMs(ms)) return false;
+		fastToTm(floorDiv(ms, 1000), tm);
+		this->t.fromTm(tm);
+		this->t.millisecond = (int)(ms - floorDiv(ms, 1000) * 1000);
+		return true;
+	}
 	if (!readTime(tm)) return false;
 	this->t.fromTm(tm);
+	this->t.millisecond = 0;
 	return true;
 }
 
 bool MAX31329::writeTime() {
+	MAX31329_TRACE(MAX31329_OP_WRITE_TIME);
 	struct tm tm;
 	this->t.toTm(tm);
 	return writeTime(tm);
 }
 
 bool MAX31329::readTime(struct tm &tm) {
+	MAX31329_TRACE(MAX31329_OP_READ_TIME);
+	if (fastEnabled || trimOn) {
+		int64_t ms;
+		if (!readEpochMs(ms)) return false;
+		fastToTm(floorDiv(ms, 1000), tm);
+		return true;
+	}
 	uint8_t regs[7];
 	if (!readBytes(MAX31329_REG_SECONDS, regs, sizeof(regs))) return false;
+	regsToTm(regs, tm);
+	return true;
+}
+
+void MAX31329::regsToTm(const uint8_t *regs, struct tm &tm) {
 	tm.tm_sec  = bcdToBin(regs[0] & 0x7F);
 	tm.tm_min  = bcdToBin(regs[1] & 0x7F);
 	tm.tm_hour = bcdToBin(regs[2] & 0x3F);
@@ -123,11 +282,12 @@ bool MAX31329::readTime(struct tm &tm) {
 	bool century = (monRaw & 0x80) != 0;
 	int year = bcdToBin(yearRaw);
 	tm.tm_year = year + (century ? 200 : 100); // years since 1900
-	tm.tm_yday = 0; tm.tm_isdst = 0;
-	return true;
+	tm.tm_yday = dayOfYear(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+	tm.tm_isdst = 0;
 }
 
 bool MAX31329::writeTime(const struct tm &tm) {
+	MAX31329_TRACE(MAX31329_OP_WRITE_TIME);
 	uint8_t regs[7];
 	regs[0] = binToBcd((uint8_t)tm.tm_sec);
 	regs[1] = binToBcd((uint8_t)tm.tm_min);
@@ -145,6 +305,7 @@ bool MAX31329::writeTime(const struct tm &tm) {
 }
 
 bool MAX31329::writeTime(int year, int month, int day, int hour, int minute, int second, int dayOfWeek) {
+	MAX31329_TRACE(MAX31329_OP_WRITE_TIME);
 	struct tm t = {};
 	t.tm_year = year - 1900;  // tm_year is years since 1900
 	t.tm_mon = month - 1;     // tm_mon is 0..11
@@ -157,6 +318,7 @@ bool MAX31329::writeTime(int year, int month, int day, int hour, int minute, int
 }
 
 bool MAX31329::readTime(int &year, int &month, int &day, int &hour, int &minute, int &second, int &dayOfWeek) {
+	MAX31329_TRACE(MAX31329_OP_READ_TIME);
 	struct tm t;
 	if (!readTime(t)) return false;
 	year = t.tm_year + 1900;  // convert back to full year
@@ -169,135 +331,524 @@ bool MAX31329::readTime(int &year, int &month, int &day, int &hour, int &minute,
 	return true;
 }
 
+bool MAX31329::enableFastTime(uint32_t resyncIntervalMs, uint32_t driftPpm) {
+	fastEnabled = true;
+	fastValid = false;
+	fastResyncMs = resyncIntervalMs;
+	fastDriftPpm = driftPpm;
+	return fastObserve();
+}
+
+void MAX31329::disableFastTime() {
+	fastEnabled = false;
+	fastValid = false;
+}
+
+bool MAX31329::syncToEdge(uint32_t timeoutMs) {
+	if (!fastEnabled) return false;
+	int64_t start = microsFn();
+	for (;;) {
+		int64_t t0 = microsFn();
+		if (!fastObserve()) return false;
+		// Reads on both sides of the edge leave a window of about two reads
+		if (fastHi - fastLo <= 3 * (microsFn() - t0)) return true;
+		if (microsFn() - start > (int64_t)timeoutMs * 1000) return false;
+	}
+}
+
+bool MAX31329::readEpochMs(int64_t &epochMs, uint32_t *errorMs) {
+	MAX31329_TRACE(MAX31329_OP_READ_TIME);
+	if (!fastEnabled) {
+		uint8_t regs[7];
+		if (!readBytes(MAX31329_REG_SECONDS, regs, sizeof(regs))) return false;
+		epochMs = regsToEpoch(regs) * 1000;
+		if (errorMs) *errorMs = 1000;
+		if (trimOn) {
+			// fastToTm() derives the weekday from this reading
+			fastEpoch = epochMs / 1000;
+			fastWday = (uint8_t)((bcdToBin(regs[3] & 0x07) + 6) % 7);
+			epochMs -= floorDiv(trimUs(epochMs * 1000) + 500, 1000);
+		}
+		return true;
+	}
+	int64_t now = microsFn();
+	if (!fastValid || now - fastSyncUs >= (int64_t)fastResyncMs * 1000) {
+		if (!fastObserve()) return false;
+		now = microsFn();
+	}
+	int64_t mid = fastLo + (fastHi - fastLo) / 2;
+	epochMs = fastEpoch * 1000 + floorDiv(now - mid, 1000);
+	if (trimOn) epochMs -= floorDiv(trimUs(epochMs * 1000) + 500, 1000);
+	if (errorMs) *errorMs = (uint32_t)((fastErrorUs(now) + 999) / 1000);
+	return true;
+}
+
+void MAX31329::setTrim(int64_t atRtcEpochUs, int64_t offsetUs, int32_t ppb) {
+	trimAtUs = atRtcEpochUs;
+	trimOffsetUs = offsetUs;
+	trimPpb = ppb;
+	trimOn = true;
+}
+
+void MAX31329::clearTrim() {
+	trimOn = false;
+}
+
+int64_t MAX31329::untrimUs(int64_t epochUs) const {
+	if (!trimOn) return epochUs;
+	// trimUs() barely changes over its own size: two fixed-point steps
+	int64_t rtcUs = epochUs + trimUs(epochUs);
+	return epochUs + trimUs(rtcUs);
+}
+
+int64_t MAX31329::trimUs(int64_t rtcEpochUs) const {
+	// Milliseconds keep the product in range for years at +-1000 ppm
+	return trimOffsetUs + floorDiv(rtcEpochUs - trimAtUs, 1000) * trimPpb / 1000000;
+}
+
+bool MAX31329::rawSample(int64_t &rtcEpochUs, int64_t &localUs, uint32_t &errorUs) {
+	MAX31329_TRACE(MAX31329_OP_READ_TIME);
+	if (fastEnabled) {
+		int64_t now = microsFn();
+		if (!fastValid || now - fastSyncUs >= (int64_t)fastResyncMs * 1000) {
+			if (!fastObserve()) return false;
+			now = microsFn();
+		}
+		rtcEpochUs = fastEpoch * 1000000 + (now - (fastLo + (fastHi - fastLo) / 2));
+		localUs = now;
+		errorUs = (uint32_t)fastErrorUs(now);
+		return true;
+	}
+	// The second read began within (t0 - 1 s, t1]
+	uint8_t regs[7];
+	int64_t t0 = microsFn();
+	if (!readBytes(MAX31329_REG_SECONDS, regs, sizeof(regs))) return false;
+	int64_t t1 = microsFn();
+	localUs = t1;
+	rtcEpochUs = regsToEpoch(regs) * 1000000 + (1000000 + (t1 - t0)) / 2;
+	errorUs = (uint32_t)((1000000 + (t1 - t0)) / 2);
+	return true;
+}
+
+void MAX31329::setMicrosSource(MAX31329_MicrosFn fn) {
+	microsFn = fn ? fn : defaultMicros;
+	fastValid = false;
+}
+
+// One chip read. The time registers latch on the START condition, so the
+// second they report began within (t0 - 1 s, t1]. Intersecting that with the
+// previous window (widened by the drift bound) narrows the anchor each time.
+bool MAX31329::fastObserve() {
+	uint8_t regs[7];
+	int64_t t0 = microsFn();
+	if (!readBytes(MAX31329_REG_SECONDS, regs, sizeof(regs))) return false;
+	int64_t t1 = microsFn();
+	int64_t epoch = regsToEpoch(regs);
+	int64_t lo = t0 - 1000000;
+	int64_t hi = t1;
+	if (fastValid) {
+		int64_t shift = (epoch - fastEpoch) * 1000000;
+		int64_t widen = (t1 - fastSyncUs) * (int64_t)fastDriftPpm / 1000000;
+		int64_t oldLo = fastLo + shift - widen;
+		int64_t oldHi = fastHi + shift + widen;
+		if (oldLo <= hi && oldHi >= lo) { // consistent: intersect
+			if (oldLo > lo) lo = oldLo;
+			if (oldHi < hi) hi = oldHi;
+		}
+	}
+	fastEpoch = epoch;
+	fastLo = lo;
+	fastHi = hi;
+	fastSyncUs = t1;
+	fastWday = (uint8_t)((bcdToBin(regs[3] & 0x07) + 6) % 7); // 1..7 -> 0..6
+	fastValid = true;
+	return true;
+}
+
+int64_t MAX31329::fastErrorUs(int64_t now) const {
+	return (fastHi - fastLo) / 2 + (now - fastSyncUs) * (int64_t)fastDriftPpm / 1000000;
+}
+
+void MAX31329::fastToTm(int64_t epochSec, struct tm &tm) const {
+	int32_t days = (int32_t)floorDiv(epochSec, 86400);
+	int32_t secs = (int32_t)(epochSec - (int64_t)days * 86400);
+	int y; unsigned m, d;
+	civilFromDays(days, y, m, d);
+	tm.tm_year = y - 1900;
+	tm.tm_mon = (int)m - 1;
+	tm.tm_mday = (int)d;
+	tm.tm_hour = secs / 3600;
+	tm.tm_min = (secs / 60) % 60;
+	tm.tm_sec = secs % 60;
+	int32_t anchorDays = (int32_t)floorDiv(fastEpoch, 86400);
+	tm.tm_wday = (int)((fastWday + (days - anchorDays) % 7 + 7) % 7);
+	tm.tm_yday = dayOfYear(y, (int)m, (int)d);
+	tm.tm_isdst = 0;
+}
+
+// Sleep through the coarse part of a timed wait, then spin to the deadline
+void MAX31329::waitUntil(int64_t localUs) {
+	int64_t left = localUs - microsFn();
+	if (left > MAX31329_PRECISE_SPIN_US) delay((uint32_t)((left - MAX31329_PRECISE_SPIN_US) / 1000));
+	while (microsFn() < localUs) {
+	}
+}
+
+bool MAX31329::writeTimePrecise(int64_t refEpochUs, int64_t capturedAtUs,
+		int32_t *residualUs, uint32_t *residualErrUs) {
+	MAX31329_TRACE(MAX31329_OP_WRITE_TIME);
+	// Use a same-length read of the time block to estimate how long the burst
+	// write takes; the write is started that much ahead of the boundary.
+	uint8_t regs[7];
+	int64_t c0 = microsFn();
+	if (!readBytes(MAX31329_REG_SECONDS, regs, sizeof(regs))) return false;
+	int64_t busUs = microsFn() - c0;
+
+	// Next whole reference second that leaves room for the write
+	int64_t now = microsFn();
+	int64_t refNow = refEpochUs + (now - capturedAtUs);
+	int64_t target = floorDiv(refNow + busUs + 1000, 1000000) + 1;
+	int64_t boundaryUs = capturedAtUs + (target * 1000000 - refEpochUs);
+	if (!epochToRegs(target, regs)) return false;
+
+	waitUntil(boundaryUs - busUs);
+	if (!writeBytes(MAX31329_REG_SECONDS, regs, sizeof(regs))) return false;
+
+	if (!residualUs) return true;
+	// Poll SECONDS until it leaves the value just written. The tick happened
+	// between the start of the last read that saw the old value and the end of
+	// the first read that saw the new one. Polling starts shortly before the
+	// expected edge; the write itself is the bound if the edge came earlier.
+	uint8_t sec = regs[0];
+	int64_t lastOld = microsFn();
+	waitUntil(boundaryUs + 1000000 - MAX31329_PRECISE_SPIN_US - busUs);
+	int64_t deadline = boundaryUs + 2000000;
+	for (;;) {
+		uint8_t v;
+		int64_t t0 = microsFn();
+		if (!readBytes(MAX31329_REG_SECONDS, &v, 1)) return false;
+		int64_t t1 = microsFn();
+		if ((v & 0x7F) != sec) {
+			int64_t edge = lastOld + (t1 - lastOld) / 2;
+			*residualUs = (int32_t)(edge - (boundaryUs + 1000000));
+			if (residualErrUs) *residualErrUs = (uint32_t)((t1 - lastOld) / 2);
+			if (fastEnabled) {
+				// Seed the interpolation anchor with the measured edge
+				fastEpoch = target + 1;
+				fastLo = lastOld;
+				fastHi = t1;
+				fastSyncUs = t1;
+				fastWday = (uint8_t)(((floorDiv(target + 1, 86400) % 7) + 11) % 7);
+				fastValid = true;
+			}
+			return true;
+		}
+		lastOld = t0;
+		if (t1 > deadline) return false;
+	}
+}
+
+bool MAX31329::readEpoch(int64_t &epoch) {
+	MAX31329_TRACE(MAX31329_OP_READ_TIME);
+	if (fastEnabled || trimOn) {
+		int64_t ms;
+		if (!readEpochMs(ms)) return false;
+		epoch = floorDiv(ms, 1000);
+		return true;
+	}
+	uint8_t regs[7];
+	if (!readBytes(MAX31329_REG_SECONDS, regs, sizeof(regs))) return false;
+	epoch = regsToEpoch(regs);
+	return true;
+}
+
+bool MAX31329::writeEpoch(int64_t epoch) {
+	MAX31329_TRACE(MAX31329_OP_WRITE_TIME);
+	uint8_t regs[7];
+	if (!epochToRegs(epoch, regs)) return false;
+	return writeBytes(MAX31329_REG_SECONDS, regs, sizeof(regs));
+}
+
+bool MAX31329::writeEpochMs(int64_t epochMs) {
+	return writeTimePrecise(epochMs * 1000, microsFn());
+}
+
+bool MAX31329::readTime(MAX31329_PackedTime &packed) {
+	int64_t epoch;
+	if (!readEpoch(epoch)) return false;
+	return packed.fromEpoch(epoch);
+}
+
+bool MAX31329::writeTime(const MAX31329_PackedTime &packed) {
+	return writeEpoch(packed.toEpoch());
+}
+
 bool MAX31329::readStatus(uint8_t &status) {
+	MAX31329_TRACE(MAX31329_OP_READ_STATUS);
 	return readBytes(MAX31329_REG_STATUS, &status, 1);
 }
 
 bool MAX31329::clearStatus() {
+	MAX31329_TRACE(MAX31329_OP_CLEAR_STATUS);
 	uint8_t dummy;
 	return readBytes(MAX31329_REG_STATUS, &dummy, 1);
 }
 
 bool MAX31329::enableInterrupts(uint8_t mask) {
+	MAX31329_TRACE(MAX31329_OP_ENABLE_INTERRUPTS);
 	uint8_t en;
-	if (!readBytes(MAX31329_REG_INT_EN, &en, 1)) return false;
+	if (!readReg(MAX31329_REG_INT_EN, en)) return false;
 	en |= mask;
 	return writeBytes(MAX31329_REG_INT_EN, &en, 1);
 }
 
 bool MAX31329::disableInterrupts(uint8_t mask) {
+	MAX31329_TRACE(MAX31329_OP_DISABLE_INTERRUPTS);
 	uint8_t en;
-	if (!readBytes(MAX31329_REG_INT_EN, &en, 1)) return false;
+	if (!readReg(MAX31329_REG_INT_EN, en)) return false;
 	en &= (uint8_t)~mask;
 	return writeBytes(MAX31329_REG_INT_EN, &en, 1);
 }
 
+bool MAX31329::setAlarm1(const MAX31329_Alarm1 &alarm) {
+	MAX31329_TRACE(MAX31329_OP_SET_ALARM);
+	if (!alarm.valid()) return false;
+	uint8_t regs[6];
+	for (uint8_t i = 0; i < sizeof(regs); ++i) regs[i] = alarm.reg(i);
+	return writeBytes(MAX31329_REG_ALM1_SEC, regs, sizeof(regs));
+}
+
+bool MAX31329::setAlarm2(const MAX31329_Alarm2 &alarm) {
+	MAX31329_TRACE(MAX31329_OP_SET_ALARM);
+	if (!alarm.valid()) return false;
+	uint8_t regs[3];
+	for (uint8_t i = 0; i < sizeof(regs); ++i) regs[i] = alarm.reg(i);
+	return writeBytes(MAX31329_REG_ALM2_MIN, regs, sizeof(regs));
+}
+
+bool MAX31329::readAlarm1(MAX31329_Alarm1 &alarm) {
+	MAX31329_TRACE(MAX31329_OP_READ_ALARM);
+	// ALM1_YEAR has no century bit, so MONTH/YEAR come along in the same
+	// burst and the alarm year is taken from the RTC's current century
+	uint8_t burst[8];
+	if (!readBytes(MAX31329_REG_MONTH, burst, sizeof(burst))) return false;
+	return decodeAlarm1(&burst[MAX31329_REG_ALM1_SEC - MAX31329_REG_MONTH],
+		(burst[0] & 0x80) != 0, alarm);
+}
+
+bool MAX31329::readAlarm2(MAX31329_Alarm2 &alarm) {
+	MAX31329_TRACE(MAX31329_OP_READ_ALARM);
+	uint8_t regs[3];
+	if (!readBytes(MAX31329_REG_ALM2_MIN, regs, sizeof(regs))) return false;
+	return decodeAlarm2(regs, alarm);
+}
+
+// regs: ALM1_SEC..ALM1_YEAR; century: the RTC's current century bit
+bool MAX31329::decodeAlarm1(const uint8_t *regs, bool century, MAX31329_Alarm1 &alarm) {
+	// Mask bits A1M1..A1M6 as a 6-bit pattern, A1M1 in bit 0
+	uint8_t masks = 0;
+	for (uint8_t i = 0; i < 5; ++i) {
+		if (regs[i] & MAX31329_ALM_MASK) masks |= (uint8_t)(1u << i);
+	}
+	if (regs[4] & MAX31329_ALM1_MON_A1M6) masks |= 0x20;
+	bool dayMatch = (regs[3] & MAX31329_ALM_DY_DT) != 0;
+	switch (masks) {
+		case 0x3F: alarm.mode = MAX31329_ALARM1_EVERY_SECOND; break;
+		case 0x3E: alarm.mode = MAX31329_ALARM1_MATCH_SECOND; break;
+		case 0x3C: alarm.mode = MAX31329_ALARM1_MATCH_MINUTE; break;
+		case 0x38: alarm.mode = MAX31329_ALARM1_MATCH_HOUR; break;
+		case 0x30: alarm.mode = dayMatch ? MAX31329_ALARM1_MATCH_DAY : MAX31329_ALARM1_MATCH_DATE; break;
+		case 0x20: if (dayMatch) return false; alarm.mode = MAX31329_ALARM1_MATCH_MONTH; break;
+		case 0x00: if (dayMatch) return false; alarm.mode = MAX31329_ALARM1_MATCH_YEAR; break;
+		default: return false;
+	}
+	alarm.second = bcdToBin(regs[0] & 0x7F);
+	alarm.minute = bcdToBin(regs[1] & 0x7F);
+	alarm.hour = bcdToBin(regs[2] & 0x3F);
+	alarm.dayOrDate = dayMatch ? (uint8_t)((regs[3] & 0x07) - 1) : bcdToBin(regs[3] & 0x3F);
+	alarm.month = bcdToBin(regs[4] & 0x1F);
+	alarm.year = (uint16_t)((century ? 2100 : 2000) + bcdToBin(regs[5]));
+	return true;
+}
+
+// regs: ALM2_MIN..ALM2DAY_DATE
+bool MAX31329::decodeAlarm2(const uint8_t *regs, MAX31329_Alarm2 &alarm) {
+	uint8_t masks = 0;
+	for (uint8_t i = 0; i < 3; ++i) {
+		if (regs[i] & MAX31329_ALM_MASK) masks |= (uint8_t)(1u << i);
+	}
+	bool dayMatch = (regs[2] & MAX31329_ALM_DY_DT) != 0;
+	switch (masks) {
+		case 0x07: alarm.mode = MAX31329_ALARM2_EVERY_MINUTE; break;
+		case 0x06: alarm.mode = MAX31329_ALARM2_MATCH_MINUTE; break;
+		case 0x04: alarm.mode = MAX31329_ALARM2_MATCH_HOUR; break;
+		case 0x00: alarm.mode = dayMatch ? MAX31329_ALARM2_MATCH_DAY : MAX31329_ALARM2_MATCH_DATE; break;
+		default: return false;
+	}
+	alarm.minute = bcdToBin(regs[0] & 0x7F);
+	alarm.hour = bcdToBin(regs[1] & 0x3F);
+	alarm.dayOrDate = dayMatch ? (uint8_t)((regs[2] & 0x07) - 1) : bcdToBin(regs[2] & 0x3F);
+	return true;
+}
+
+bool MAX31329::snapshot(MAX31329_Snapshot &snap, bool verify) {
+	MAX31329_TRACE(MAX31329_OP_SNAPSHOT);
+	uint8_t *r = snap.regs;
+	for (int attempt = 0; ; ++attempt) {
+		if (!readBytes(MAX31329_REG_STATUS, r, MAX31329_SNAPSHOT_REGS)) return false;
+		if (!verify) break;
+		uint8_t sec;
+		if (!readBytes(MAX31329_REG_SECONDS, &sec, 1)) return false;
+		uint8_t a = bcdToBin(r[MAX31329_REG_SECONDS] & 0x7F);
+		uint8_t b = bcdToBin(sec & 0x7F);
+		if (b == a || b == (a + 1) % 60) break;
+		if (attempt) return false;
+	}
+	snap.status = r[MAX31329_REG_STATUS];
+	snap.intEnable = r[MAX31329_REG_INT_EN];
+	snap.rtcReset = r[MAX31329_REG_RTC_RESET];
+	snap.config1 = r[MAX31329_REG_CFG1];
+	snap.config2 = r[MAX31329_REG_CFG2];
+	snap.timerConfig = r[MAX31329_REG_TIMER_CONFIG];
+
+	struct tm tm;
+	regsToTm(&r[MAX31329_REG_SECONDS], tm);
+	snap.time.fromTm(tm);
+	snap.time.millisecond = 0;
+	snap.epoch = regsToEpoch(&r[MAX31329_REG_SECONDS]);
+
+	bool century = (r[MAX31329_REG_MONTH] & 0x80) != 0;
+	snap.alarm1Valid = decodeAlarm1(&r[MAX31329_REG_ALM1_SEC], century, snap.alarm1);
+	snap.alarm2Valid = decodeAlarm2(&r[MAX31329_REG_ALM2_MIN], snap.alarm2);
+
+	snap.timerCount = r[MAX31329_REG_TIMER_COUNT];
+	snap.timerInit = r[MAX31329_REG_TIMER_INIT];
+	snap.powerMgmt = r[MAX31329_REG_PWR_MGMT];
+	snap.trickle = r[MAX31329_REG_TRICKLE];
+	return true;
+}
+
 bool MAX31329::startRTC() {
+	MAX31329_TRACE(MAX31329_OP_START_RTC);
 	uint8_t v;
-	if (!readBytes(MAX31329_REG_CFG1, &v, 1)) return false;
+	if (!readReg(MAX31329_REG_CFG1, v)) return false;
 	v |= MAX31329_CFG1_ENOSC;
 	return writeBytes(MAX31329_REG_CFG1, &v, 1);
 }
 
 bool MAX31329::stopRTC() {
+	MAX31329_TRACE(MAX31329_OP_STOP_RTC);
 	uint8_t v;
-	if (!readBytes(MAX31329_REG_CFG1, &v, 1)) return false;
+	if (!readReg(MAX31329_REG_CFG1, v)) return false;
 	v &= (uint8_t)~MAX31329_CFG1_ENOSC;
 	return writeBytes(MAX31329_REG_CFG1, &v, 1);
 }
 
 bool MAX31329::assertReset() {
+	MAX31329_TRACE(MAX31329_OP_ASSERT_RESET);
 	uint8_t v = MAX31329_RESET_SWRST;
 	return writeBytes(MAX31329_REG_RTC_RESET, &v, 1);
 }
 
 bool MAX31329::releaseReset() {
+	MAX31329_TRACE(MAX31329_OP_RELEASE_RESET);
 	uint8_t v = 0;
 	return writeBytes(MAX31329_REG_RTC_RESET, &v, 1);
 }
 
 bool MAX31329::clkoEnable(uint8_t freqSel) {
+	MAX31329_TRACE(MAX31329_OP_CLKO_ENABLE);
 	uint8_t cfg2;
-	if (!readBytes(MAX31329_REG_CFG2, &cfg2, 1)) return false;
+	if (!readReg(MAX31329_REG_CFG2, cfg2)) return false;
 	cfg2 |= MAX31329_CFG2_ENCLKO;
-	cfg2 &= (uint8_t)~MAX31329_CFG2_CLKO_HZ_MASK;
-	cfg2 |= (uint8_t)((freqSel & 0x03) << MAX31329_CFG2_CLKO_HZ_POS);
+	cfg2 &= (uint8_t)~MAX31329_FIELD_CLKO_HZ::mask;
+	cfg2 |= MAX31329_FIELD_CLKO_HZ::encode(freqSel);
 	return writeBytes(MAX31329_REG_CFG2, &cfg2, 1);
 }
 
 bool MAX31329::clkoDisable() {
+	MAX31329_TRACE(MAX31329_OP_CLKO_DISABLE);
 	uint8_t cfg2;
-	if (!readBytes(MAX31329_REG_CFG2, &cfg2, 1)) return false;
+	if (!readReg(MAX31329_REG_CFG2, cfg2)) return false;
 	cfg2 &= (uint8_t)~MAX31329_CFG2_ENCLKO;
 	return writeBytes(MAX31329_REG_CFG2, &cfg2, 1);
 }
 
 bool MAX31329::clkinDisable() {
+	MAX31329_TRACE(MAX31329_OP_CLKIN_DISABLE);
 	uint8_t cfg2;
-	if (!readBytes(MAX31329_REG_CFG2, &cfg2, 1)) return false;
+	if (!readReg(MAX31329_REG_CFG2, cfg2)) return false;
 	cfg2 &= (uint8_t)~MAX31329_CFG2_ENCLKIN;
 	return writeBytes(MAX31329_REG_CFG2, &cfg2, 1);
 }
 
 bool MAX31329::timerConfigure(uint8_t initialValue, bool repeat, uint8_t freqSel) {
+	MAX31329_TRACE(MAX31329_OP_TIMER_CONFIGURE);
 	uint8_t cfg;
-	if (!readBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1)) return false;
+	if (!readReg(MAX31329_REG_TIMER_CONFIG, cfg)) return false;
 	cfg &= (uint8_t)~MAX31329_TMR_TE;
 	cfg |= MAX31329_TMR_TPAUSE;
 	if (repeat) cfg |= MAX31329_TMR_TRPT; else cfg &= (uint8_t)~MAX31329_TMR_TRPT;
-	cfg &= (uint8_t)~MAX31329_TMR_TFS_MASK;
-	cfg |= (uint8_t)((freqSel & 0x03) << MAX31329_TMR_TFS_POS);
+	cfg &= (uint8_t)~MAX31329_FIELD_TFS::mask;
+	cfg |= MAX31329_FIELD_TFS::encode(freqSel);
 	if (!writeBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1)) return false;
 	return writeBytes(MAX31329_REG_TIMER_INIT, &initialValue, 1);
 }
 
 bool MAX31329::timerStart() {
+	MAX31329_TRACE(MAX31329_OP_TIMER_START);
 	uint8_t cfg;
-	if (!readBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1)) return false;
+	if (!readReg(MAX31329_REG_TIMER_CONFIG, cfg)) return false;
 	cfg |= MAX31329_TMR_TE;
 	cfg &= (uint8_t)~MAX31329_TMR_TPAUSE;
 	return writeBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1);
 }
 
 bool MAX31329::timerPause() {
+	MAX31329_TRACE(MAX31329_OP_TIMER_PAUSE);
 	uint8_t cfg;
-	if (!readBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1)) return false;
+	if (!readReg(MAX31329_REG_TIMER_CONFIG, cfg)) return false;
 	cfg |= MAX31329_TMR_TE;
 	cfg |= MAX31329_TMR_TPAUSE;
 	return writeBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1);
 }
 
 bool MAX31329::timerContinue() {
+	MAX31329_TRACE(MAX31329_OP_TIMER_CONTINUE);
 	uint8_t cfg;
-	if (!readBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1)) return false;
+	if (!readReg(MAX31329_REG_TIMER_CONFIG, cfg)) return false;
 	cfg |= MAX31329_TMR_TE;
 	cfg &= (uint8_t)~MAX31329_TMR_TPAUSE;
 	return writeBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1);
 }
 
 bool MAX31329::timerStop() {
+	MAX31329_TRACE(MAX31329_OP_TIMER_STOP);
 	uint8_t cfg;
-	if (!readBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1)) return false;
+	if (!readReg(MAX31329_REG_TIMER_CONFIG, cfg)) return false;
 	cfg &= (uint8_t)~MAX31329_TMR_TE;
 	cfg |= MAX31329_TMR_TPAUSE;
 	return writeBytes(MAX31329_REG_TIMER_CONFIG, &cfg, 1);
 }
 
 bool MAX31329::timerRead(uint8_t &value) {
+	MAX31329_TRACE(MAX31329_OP_TIMER_READ);
 	return readBytes(MAX31329_REG_TIMER_COUNT, &value, 1);
 }
 
 bool MAX31329::setPowerFailThreshold(uint8_t pfvt) {
+	MAX31329_TRACE(MAX31329_OP_SET_POWER_FAIL_THRESHOLD);
 	uint8_t v;
-	if (!readBytes(MAX31329_REG_PWR_MGMT, &v, 1)) return false;
-	v &= (uint8_t)~MAX31329_PWR_PFVT_MASK;
-	v |= (uint8_t)((pfvt & 0x03) << MAX31329_PWR_PFVT_POS);
+	if (!readReg(MAX31329_REG_PWR_MGMT, v)) return false;
+	v &= (uint8_t)~MAX31329_FIELD_PFVT::mask;
+	v |= MAX31329_FIELD_PFVT::encode(pfvt);
 	return writeBytes(MAX31329_REG_PWR_MGMT, &v, 1);
 }
 
 bool MAX31329::selectSupply(uint8_t supply) {
+	MAX31329_TRACE(MAX31329_OP_SELECT_SUPPLY);
 	uint8_t v;
-	if (!readBytes(MAX31329_REG_PWR_MGMT, &v, 1)) return false;
+	if (!readReg(MAX31329_REG_PWR_MGMT, v)) return false;
 	switch (supply) {
 		case 1: // VCC
 			v |= MAX31329_PWR_DMAN_SEL; v &= (uint8_t)~MAX31329_PWR_D_VBACK_SEL; break;
@@ -310,20 +861,234 @@ bool MAX31329::selectSupply(uint8_t supply) {
 }
 
 bool MAX31329::trickleEnable(uint8_t path) {
+	MAX31329_TRACE(MAX31329_OP_TRICKLE_ENABLE);
 	uint8_t v = 0;
 	v |= MAX31329_TRK_D_TRKCHG_EN;
-	v |= (uint8_t)((path & 0x0F) << MAX31329_TRK_D_TRICKLE_POS);
+	v |= MAX31329_FIELD_D_TRICKLE::encode(path);
 	return writeBytes(MAX31329_REG_TRICKLE, &v, 1);
 }
 
 bool MAX31329::trickleDisable() {
+	MAX31329_TRACE(MAX31329_OP_TRICKLE_DISABLE);
 	uint8_t v;
-	if (!readBytes(MAX31329_REG_TRICKLE, &v, 1)) return false;
+	if (!readReg(MAX31329_REG_TRICKLE, v)) return false;
 	v &= (uint8_t)~MAX31329_TRK_D_TRKCHG_EN;
 	return writeBytes(MAX31329_REG_TRICKLE, &v, 1);
 }
 
+MAX31329_Transaction::MAX31329_Transaction() {
+	clear();
+}
+
+void MAX31329_Transaction::clear() {
+	memset(mask, 0, sizeof(mask));
+	memset(value, 0, sizeof(value));
+	reload = false;
+}
+
+bool MAX31329_Transaction::empty() const {
+	for (uint8_t i = 0; i < SLOTS; ++i) {
+		if (mask[i]) return false;
+	}
+	return true;
+}
+
+int MAX31329_Transaction::slotOf(uint8_t reg) {
+	if (reg >= MAX31329_REG_INT_EN && reg <= MAX31329_REG_TIMER_CONFIG) return reg - MAX31329_REG_INT_EN;
+	if (reg >= MAX31329_REG_TIMER_INIT && reg <= MAX31329_REG_TRICKLE) return 5 + (reg - MAX31329_REG_TIMER_INIT);
+	return -1;
+}
+
+bool MAX31329_Transaction::setBits(uint8_t reg, uint8_t m, uint8_t v) {
+	int slot = slotOf(reg);
+	if (slot < 0) return false;
+	mask[slot] |= m;
+	value[slot] = (uint8_t)((value[slot] & ~m) | (v & m));
+	return true;
+}
+
+bool MAX31329_Transaction::setRegister(uint8_t reg, uint8_t v) {
+	return setBits(reg, 0xFF, v);
+}
+
+void MAX31329_Transaction::enableInterrupts(uint8_t m) {
+	setBits(MAX31329_REG_INT_EN, m, m);
+}
+
+void MAX31329_Transaction::disableInterrupts(uint8_t m) {
+	setBits(MAX31329_REG_INT_EN, m, 0);
+}
+
+void MAX31329_Transaction::startRTC() {
+	setBits(MAX31329_REG_CFG1, MAX31329_CFG1_ENOSC, MAX31329_CFG1_ENOSC);
+}
+
+void MAX31329_Transaction::stopRTC() {
+	setBits(MAX31329_REG_CFG1, MAX31329_CFG1_ENOSC, 0);
+}
+
+void MAX31329_Transaction::assertReset() {
+	setRegister(MAX31329_REG_RTC_RESET, MAX31329_RESET_SWRST);
+}
+
+void MAX31329_Transaction::releaseReset() {
+	setRegister(MAX31329_REG_RTC_RESET, 0);
+}
+
+void MAX31329_Transaction::clkoEnable(uint8_t freqSel) {
+	setBits(MAX31329_REG_CFG2, MAX31329_CFG2_ENCLKO | MAX31329_CFG2_CLKO_HZ_MASK,
+		(uint8_t)(MAX31329_CFG2_ENCLKO | MAX31329_FIELD_CLKO_HZ::encode(freqSel)));
+}
+
+void MAX31329_Transaction::clkoDisable() {
+	setBits(MAX31329_REG_CFG2, MAX31329_CFG2_ENCLKO, 0);
+}
+
+void MAX31329_Transaction::clkinDisable() {
+	setBits(MAX31329_REG_CFG2, MAX31329_CFG2_ENCLKIN, 0);
+}
+
+void MAX31329_Transaction::timerConfigure(uint8_t initialValue, bool repeat, uint8_t freqSel) {
+	setBits(MAX31329_REG_TIMER_CONFIG,
+		MAX31329_TMR_TE | MAX31329_TMR_TPAUSE | MAX31329_TMR_TRPT | MAX31329_TMR_TFS_MASK,
+		(uint8_t)(MAX31329_TMR_TPAUSE | (repeat ? MAX31329_TMR_TRPT : 0) | MAX31329_FIELD_TFS::encode(freqSel)));
+	setRegister(MAX31329_REG_TIMER_INIT, initialValue);
+	reload = true;
+}
+
+void MAX31329_Transaction::timerStart() {
+	setBits(MAX31329_REG_TIMER_CONFIG, MAX31329_TMR_TE | MAX31329_TMR_TPAUSE, MAX31329_TMR_TE);
+}
+
+void MAX31329_Transaction::timerPause() {
+	setBits(MAX31329_REG_TIMER_CONFIG, MAX31329_TMR_TE | MAX31329_TMR_TPAUSE, MAX31329_TMR_TE | MAX31329_TMR_TPAUSE);
+}
+
+void MAX31329_Transaction::timerContinue() {
+	setBits(MAX31329_REG_TIMER_CONFIG, MAX31329_TMR_TE | MAX31329_TMR_TPAUSE, MAX31329_TMR_TE);
+}
+
+void MAX31329_Transaction::timerStop() {
+	setBits(MAX31329_REG_TIMER_CONFIG, MAX31329_TMR_TE | MAX31329_TMR_TPAUSE, MAX31329_TMR_TPAUSE);
+}
+
+void MAX31329_Transaction::setPowerFailThreshold(uint8_t pfvt) {
+	setField<MAX31329_FIELD_PFVT>(pfvt);
+}
+
+void MAX31329_Transaction::selectSupply(uint8_t supply) {
+	switch (supply) {
+		case 1: // VCC
+			setBits(MAX31329_REG_PWR_MGMT, MAX31329_PWR_DMAN_SEL | MAX31329_PWR_D_VBACK_SEL, MAX31329_PWR_DMAN_SEL); break;
+		case 2: // VBACKUP
+			setBits(MAX31329_REG_PWR_MGMT, MAX31329_PWR_DMAN_SEL | MAX31329_PWR_D_VBACK_SEL,
+				MAX31329_PWR_DMAN_SEL | MAX31329_PWR_D_VBACK_SEL); break;
+		case 0: default: // AUTO
+			setBits(MAX31329_REG_PWR_MGMT, MAX31329_PWR_DMAN_SEL, 0); break;
+	}
+}
+
+void MAX31329_Transaction::trickleEnable(uint8_t path) {
+	setRegister(MAX31329_REG_TRICKLE, (uint8_t)(MAX31329_TRK_D_TRKCHG_EN | MAX31329_FIELD_D_TRICKLE::encode(path)));
+}
+
+void MAX31329_Transaction::trickleDisable() {
+	setBits(MAX31329_REG_TRICKLE, MAX31329_TRK_D_TRKCHG_EN, 0);
+}
+
+bool MAX31329::commit(const MAX31329_Transaction &tx, size_t *transfers) {
+	MAX31329_TRACE(MAX31329_OP_COMMIT);
+	size_t count = 0;
+	// The timer loads TIMER_INIT on a TE 0->1 edge only. After a staged
+	// timerConfigure() + timerStart() the first block goes out with TE clear
+	// (which also stops a running timer), then TIMER_INIT, then TE alone.
+	const int cfg = MAX31329_Transaction::slotOf(MAX31329_REG_TIMER_CONFIG);
+	bool restart = tx.reload && (tx.mask[cfg] & tx.value[cfg] & MAX31329_TMR_TE);
+	MAX31329_Transaction stopped = tx;
+	if (restart) stopped.value[cfg] &= (uint8_t)~MAX31329_TMR_TE;
+	uint8_t timerCfg = 0;
+	bool ok = commitBlock(stopped, MAX31329_REG_INT_EN, 5, count, &timerCfg) &&
+		commitBlock(tx, MAX31329_REG_TIMER_INIT, 3, count);
+	if (ok && restart) {
+		timerCfg |= MAX31329_TMR_TE;
+		count++;
+		ok = writeBytes(MAX31329_REG_TIMER_CONFIG, &timerCfg, 1);
+	}
+	if (transfers) *transfers = count;
+	return ok;
+}
+
+// Commit one contiguous register block. Two plans are costed and the cheaper
+// one is used:
+//  - runs: write each run of staged registers separately; read only the
+//    partially staged registers whose base value the shadow cannot supply.
+//  - span: write first..last staged register in one burst, filling gaps with
+//    current values; read whatever in the span the shadow cannot supply.
+// Ties go to runs so untouched registers are never rewritten. If the block's
+// last register is staged, the value written to it is left in lastValue.
+bool MAX31329::commitBlock(const MAX31329_Transaction &tx, uint8_t firstReg, uint8_t count, size_t &transfers,
+		uint8_t *lastValue) {
+	const int base = MAX31329_Transaction::slotOf(firstReg);
+	uint8_t cur[5];
+	bool known[5];
+	int first = -1, last = -1;
+	for (uint8_t i = 0; i < count; ++i) {
+		int slot = shadowSlot((uint8_t)(firstReg + i));
+		known[i] = shadowEnabled && slot >= 0 && (shadowValid & (1u << slot));
+		cur[i] = known[i] ? shadowRegs[slot] : 0;
+		if (tx.mask[base + i]) {
+			if (first < 0) first = i;
+			last = i;
+		}
+	}
+	if (first < 0) return true;
+
+	int runs = 0, runReadLo = -1, runReadHi = -1, spanReadLo = -1, spanReadHi = -1;
+	for (int i = first; i <= last; ++i) {
+		uint8_t m = tx.mask[base + i];
+		if (m && (i == first || !tx.mask[base + i - 1])) runs++;
+		if (m != 0xFF && !known[i]) {
+			if (spanReadLo < 0) spanReadLo = i;
+			spanReadHi = i;
+			if (m) {
+				if (runReadLo < 0) runReadLo = i;
+				runReadHi = i;
+			}
+		}
+	}
+	int runCost = runs + (runReadLo >= 0 ? 1 : 0);
+	int spanCost = 1 + (spanReadLo >= 0 ? 1 : 0);
+	bool span = spanCost < runCost;
+	int readLo = span ? spanReadLo : runReadLo;
+	int readHi = span ? spanReadHi : runReadHi;
+
+	if (readLo >= 0) {
+		if (!readBytes((uint8_t)(firstReg + readLo), &cur[readLo], (size_t)(readHi - readLo + 1))) return false;
+		transfers++;
+	}
+	for (int i = first; i <= last; ++i) {
+		uint8_t m = tx.mask[base + i];
+		cur[i] = (uint8_t)((cur[i] & ~m) | (tx.value[base + i] & m));
+	}
+	if (lastValue) *lastValue = cur[count - 1];
+
+	if (span) {
+		transfers++;
+		return writeBytes((uint8_t)(firstReg + first), &cur[first], (size_t)(last - first + 1));
+	}
+	for (int i = first; i <= last; ) {
+		if (!tx.mask[base + i]) { ++i; continue; }
+		int j = i;
+		while (j + 1 <= last && tx.mask[base + j + 1]) ++j;
+		transfers++;
+		if (!writeBytes((uint8_t)(firstReg + i), &cur[i], (size_t)(j - i + 1))) return false;
+		i = j + 1;
+	}
+	return true;
+}
+
 bool MAX31329::readRam(uint8_t offset, uint8_t *buffer, size_t length) {
+	MAX31329_TRACE(MAX31329_OP_READ_RAM);
 	if (!buffer || length == 0) return false;
 	uint16_t span = (uint16_t)(MAX31329_REG_RAM_END - MAX31329_REG_RAM_START + 1);
 	if ((uint16_t)offset + length > span) return false;
@@ -331,18 +1096,224 @@ bool MAX31329::readRam(uint8_t offset, uint8_t *buffer, size_t length) {
 }
 
 bool MAX31329::writeRam(uint8_t offset, const uint8_t *buffer, size_t length) {
+	MAX31329_TRACE(MAX31329_OP_WRITE_RAM);
 	if (!buffer || length == 0) return false;
 	uint16_t span = (uint16_t)(MAX31329_REG_RAM_END - MAX31329_REG_RAM_START + 1);
 	if ((uint16_t)offset + length > span) return false;
 	return writeBytes((uint8_t)(MAX31329_REG_RAM_START + offset), buffer, length);
 }
 
+void MAX31329::setShadowCache(bool enable) {
+	shadowEnabled = enable;
+	shadowValid = 0;
+}
+
+bool MAX31329::shadowResync() {
+	MAX31329_TRACE(MAX31329_OP_SHADOW_RESYNC);
+	if (!shadowEnabled) return false;
+	shadowValid = 0;
+	// readBytes() refreshes the shadow for every register it covers
+	uint8_t cfg[5];
+	if (!readBytes(MAX31329_REG_INT_EN, cfg, sizeof(cfg))) return false;
+	uint8_t pwr[2];
+	return readBytes(MAX31329_REG_PWR_MGMT, pwr, sizeof(pwr));
+}
+
+void MAX31329::shadowInvalidate() {
+	shadowValid = 0;
+}
+
+MAX31329_ShadowStats MAX31329::shadowStats() const {
+	return shadowCounters;
+}
+
+void MAX31329::shadowStatsReset() {
+	shadowCounters = MAX31329_ShadowStats();
+}
+
+int MAX31329::shadowSlot(uint8_t reg) {
+	switch (reg) {
+		case MAX31329_REG_INT_EN:       return 0;
+		case MAX31329_REG_CFG1:         return 1;
+		case MAX31329_REG_CFG2:         return 2;
+		case MAX31329_REG_TIMER_CONFIG: return 3;
+		case MAX31329_REG_PWR_MGMT:     return 4;
+		case MAX31329_REG_TRICKLE:      return 5;
+		default:                        return -1;
+	}
+}
+
+void MAX31329::shadowUpdate(uint8_t reg, const uint8_t *buffer, size_t length, bool valid) {
+	for (size_t i = 0; i < length; ++i) {
+		int slot = shadowSlot((uint8_t)(reg + i));
+		if (slot < 0) continue;
+		if (valid) {
+			shadowRegs[slot] = buffer[i];
+			shadowValid |= (uint8_t)(1u << slot);
+		} else {
+			shadowValid &= (uint8_t)~(1u << slot);
+		}
+	}
+}
+
+bool MAX31329::readReg(uint8_t reg, uint8_t &value) {
+	int slot = shadowSlot(reg);
+	if (shadowEnabled && slot >= 0) {
+		if (shadowValid & (1u << slot)) {
+			value = shadowRegs[slot];
+			shadowCounters.hits++;
+			return true;
+		}
+		shadowCounters.misses++;
+	}
+	return readBytes(reg, &value, 1);
+}
+
+#if KODE_MAX31329_STATS
+MAX31329::StatsScope::StatsScope(MAX31329 &r, MAX31329_Op op)
+	: rtc(r), prevOp(r.statsOp), startUs((uint32_t)micros()) {
+	if (prevOp == MAX31329_OP_OTHER) rtc.statsOp = op;
+}
+
+MAX31329::StatsScope::~StatsScope() {
+	if (prevOp != MAX31329_OP_OTHER) return; // nested call, outer scope accounts
+	MAX31329_OpStats &s = rtc.stats.ops[rtc.statsOp];
+	uint32_t elapsed = (uint32_t)micros() - startUs;
+	uint8_t bucket = 0;
+	while (bucket < MAX31329_STATS_BUCKETS - 1 && elapsed >= (MAX31329_STATS_BUCKET0_US << bucket)) bucket++;
+	s.calls++;
+	s.latency[bucket]++;
+	rtc.statsOp = MAX31329_OP_OTHER;
+}
+
+void MAX31329::statsRecord(size_t length, bool ok) {
+	MAX31329_OpStats &s = stats.ops[statsOp];
+	s.transactions++;
+	s.bytes += (uint32_t)(length + 1);
+	if (!ok) s.failures++;
+}
+
+void MAX31329::statsSnapshot(MAX31329_Stats &out) const {
+	out = stats;
+}
+
+void MAX31329::statsReset() {
+	stats = MAX31329_Stats();
+}
+
+const char *MAX31329::opName(MAX31329_Op op) {
+	static const char *const names[MAX31329_OP_COUNT] = {
+		"other", "begin", "isConnected", "readTime", "writeTime", "readStatus",
+		"clearStatus", "enableInterrupts", "disableInterrupts", "setAlarm", "readAlarm",
+		"startRTC", "stopRTC", "assertReset", "releaseReset", "clkoEnable",
+		"clkoDisable", "clkinDisable",
+		"timerConfigure", "timerStart", "timerPause", "timerContinue", "timerStop",
+		"timerRead", "setPowerFailThreshold", "selectSupply", "trickleEnable",
+		"trickleDisable", "shadowResync", "commit", "readRam", "writeRam",
+		"snapshot",
+	};
+	return (op < MAX31329_OP_COUNT) ? names[op] : "?";
+}
+#endif
+
+void MAX31329::setRetry(uint8_t retries, uint16_t backoffUs, uint32_t deadlineUs) {
+	retryCount = retries;
+	retryBackoffUs = backoffUs;
+	retryDeadlineUs = deadlineUs;
+}
+
+void MAX31329::setBusTimeout(uint16_t ms) {
+	busTimeoutMs = ms;
+	if (bus.attached() && ms) bus.setTimeout(ms);
+}
+
+bool MAX31329::recoverBus() {
+	if (!bus.attached()) return false;
+	++health.recoveries;
+	return bus.recover();
+}
+
+bool MAX31329::setI2cTimeout(bool enable) {
+	return writeField<MAX31329_FIELD_I2C_TIMEOUT>(enable ? 1 : 0);
+}
+
+uint32_t MAX31329::worstCaseUs() const {
+	uint32_t attemptUs = (uint32_t)(busTimeoutMs ? busTimeoutMs : MAX31329_BUS_DEFAULT_TIMEOUT_MS) * 1000;
+	if (autoRecover) attemptUs += MAX31329_BUS_RECOVERY_US;
+	uint32_t total = attemptUs;
+	uint32_t backoff = retryBackoffUs;
+	for (uint8_t i = 0; i < retryCount; ++i) {
+		total += backoff + attemptUs;
+		backoff *= 2;
+	}
+	// Retries are only started when they fit the deadline
+	if (retryDeadlineUs && total > retryDeadlineUs) total = retryDeadlineUs > attemptUs ? retryDeadlineUs : attemptUs;
+	return total;
+}
+
+// One register transfer with the retry policy applied. in != nullptr reads.
+bool MAX31329::transfer(uint8_t reg, uint8_t *in, const uint8_t *out, size_t length) {
+	if (!bus.attached()) {
+		lastErr = MAX31329_ERR_NOT_ATTACHED;
+		return false;
+	}
+	int64_t start = microsFn();
+	uint32_t attemptUs = (uint32_t)(busTimeoutMs ? busTimeoutMs : MAX31329_BUS_DEFAULT_TIMEOUT_MS) * 1000;
+	uint32_t backoff = retryBackoffUs;
+	bool ok = false;
+	for (uint8_t attempt = 0;; ++attempt) {
+		ok = in ? bus.read(reg, in, length) : bus.write(reg, out, length);
+#if KODE_MAX31329_STATS
+		statsRecord(length, ok);
+#endif
+		lastErr = ok ? MAX31329_OK : bus.error();
+		if (ok || attempt >= retryCount || lastErr == MAX31329_ERR_LENGTH) break;
+		bool recover = autoRecover && (lastErr == MAX31329_ERR_TIMEOUT ||
+			lastErr == MAX31329_ERR_BUS || lastErr == MAX31329_ERR_SHORT_READ);
+		if (retryDeadlineUs) {
+			int64_t need = (int64_t)(microsFn() - start) + backoff + attemptUs +
+				(recover ? MAX31329_BUS_RECOVERY_US : 0);
+			if (need > (int64_t)retryDeadlineUs) {
+				lastErr = MAX31329_ERR_DEADLINE;
+				break;
+			}
+		}
+		if (recover) {
+			++health.recoveries;
+			bus.recover();
+		}
+		if (backoff) delayMicroseconds(backoff);
+		backoff = backoff < 0x80000000u ? backoff * 2 : backoff;
+		++health.retries;
+	}
+	uint32_t elapsed = (uint32_t)(microsFn() - start);
+	if (elapsed > health.worstUs) health.worstUs = elapsed;
+	if (!ok) ++health.failures;
+	return ok;
+}
+
 bool MAX31329::readBytes(uint8_t reg, uint8_t *buffer, size_t length) {
-	if (!wireBus) return false;
-	return i2cWriteThenRead(*wireBus, MAX31329_I2C_ADDRESS, reg, buffer, length);
+	bool ok = transfer(reg, buffer, nullptr, length);
+	if (ok && shadowEnabled) shadowUpdate(reg, buffer, length, true);
+	return ok;
 }
 
 bool MAX31329::writeBytes(uint8_t reg, const uint8_t *buffer, size_t length) {
-	if (!wireBus) return false;
-	return i2cWriteBytes(*wireBus, MAX31329_I2C_ADDRESS, reg, buffer, length);
+	bool ok = transfer(reg, nullptr, buffer, length);
+	// A failed write leaves the device state unknown, so drop those slots
+	if (shadowEnabled) shadowUpdate(reg, buffer, length, ok);
+	// Time or oscillator changes break the interpolation anchor; a new
+	// time also invalidates the trim offset
+	bool timeWrite = reg <= MAX31329_REG_YEAR && reg + length > MAX31329_REG_SECONDS;
+	if (timeWrite || (reg <= MAX31329_REG_CFG1 && reg + length > MAX31329_REG_CFG1)) fastValid = false;
+	if (timeWrite) trimOn = false;
+	// SWRST returns every config register to its default and holds the
+	// oscillator, whichever call (or commit()) wrote it. A failed write may
+	// still have reached the chip.
+	if (reg <= MAX31329_REG_RTC_RESET && reg + length > MAX31329_REG_RTC_RESET &&
+		(buffer[MAX31329_REG_RTC_RESET - reg] & MAX31329_RESET_SWRST)) {
+		shadowInvalidate();
+		fastValid = false;
+	}
+	return ok;
 }
@@ -17,7 +17,9 @@
 #ifndef KODE_MAX31329_H
 #define KODE_MAX31329_H
 
-#if !defined(ARDUINO_ARCH_ESP32)
+// KODE_MAX31329_HOST lets off-target builds (host test benches supplying their
+// own Arduino.h / Wire.h stand-ins) compile the driver.
+#if !defined(ARDUINO_ARCH_ESP32) && !defined(KODE_MAX31329_HOST)
 #error "kode_MAX31329: This library targets kode dot (ESP32-S3) only."
 #endif
 
@@ -26,6 +28,27 @@
 #include <time.h>
 
 #include "MAX31329_registers.h"
+#include "MAX31329_fields.h"
+#include "MAX31329_bus.h"
+#include "MAX31329_alarm.h"
+#include "MAX31329_stats.h"
+
+// Bus policy selection (see MAX31329_bus.h)
+#if defined(KODE_MAX31329_BUS)
+typedef KODE_MAX31329_BUS MAX31329_Bus;
+#elif defined(KODE_MAX31329_IDF_BUS) && KODE_MAX31329_IDF_BUS
+typedef MAX31329_IdfBus MAX31329_Bus;
+#else
+#define MAX31329_BUS_WIRE 1
+typedef MAX31329_WireBus MAX31329_Bus;
+#endif
+
+// writeTimePrecise() sleeps in delay() until this long before a deadline and
+// spins on the micros source for the rest. Raise it when higher-priority
+// tasks can hold the caller past its wake-up.
+#ifndef MAX31329_PRECISE_SPIN_US
+#define MAX31329_PRECISE_SPIN_US 500
+#endif
 
 // Time structure with convenient access
 struct MAX31329_Time {
@@ -36,12 +59,126 @@ struct MAX31329_Time {
 	int minute = 0;       // 0..59
 	int second = 0;       // 0..59
 	int dayOfWeek = 0;    // 0..6 (0=Sunday)
+	int millisecond = 0;  // 0..999 (interpolated reads only, see enableFastTime)
 	
 	// Convert to/from struct tm
 	void toTm(struct tm &t) const;
 	void fromTm(const struct tm &t);
 };
 
+// Shadow cache counters (see MAX31329::setShadowCache)
+struct MAX31329_ShadowStats {
+	uint32_t hits = 0;    // register reads served from the shadow (I2C transactions saved)
+	uint32_t misses = 0;  // shadowed register reads that had to go to the bus
+};
+
+// Bus robustness counters (see MAX31329::setRetry)
+struct MAX31329_BusHealth {
+	uint32_t retries = 0;     // transfers repeated after a failure
+	uint32_t recoveries = 0;  // SCL recovery sequences run
+	uint32_t failures = 0;    // readBytes()/writeBytes() calls that gave up
+	uint32_t worstUs = 0;     // slowest readBytes()/writeBytes(), retries included
+};
+
+// Staged configuration changes, committed with MAX31329::commit().
+// Covers INT_EN..TIMER_CONFIG (0x01-0x05) and TIMER_INIT..TRICKLE (0x17-0x19).
+// Staging methods mirror the MAX31329 control calls but touch no bus.
+class MAX31329_Transaction {
+public:
+	MAX31329_Transaction();
+
+	void clear();
+	bool empty() const;
+
+	// Stage value bits under mask for reg; false if reg is not stageable
+	bool setBits(uint8_t reg, uint8_t mask, uint8_t value);
+	bool setRegister(uint8_t reg, uint8_t value);
+
+	// Typed fields (MAX31329_fields.h). setField truncates value to the field
+	// width; set<> takes compile-time values and folds them per register.
+	template <typename Field> bool setField(uint8_t value) {
+		static_assert(Field::access == MAX31329_ACCESS_RW, "field is read-only");
+		return setBits(Field::reg, Field::mask, Field::encode(value));
+	}
+	template <typename... Sets> void set() {
+		typedef MAX31329_FieldSet<Sets...> Set;
+		static_assert(Set::disjoint(), "a field is set twice");
+		static_assert((Set::regs() & ~STAGEABLE) == 0, "register cannot be staged");
+		MAX31329_FieldStager<Set, Sets...>::apply(*this);
+	}
+
+	void enableInterrupts(uint8_t mask);
+	void disableInterrupts(uint8_t mask);
+	void startRTC();
+	void stopRTC();
+	void assertReset();
+	void releaseReset();
+	void clkoEnable(uint8_t freqSel);
+	void clkoDisable();
+	void clkinDisable();
+	void timerConfigure(uint8_t initialValue, bool repeat, uint8_t freqSel);
+	void timerStart();
+	void timerPause();
+	void timerContinue();
+	void timerStop();
+	void setPowerFailThreshold(uint8_t pfvt);
+	void selectSupply(uint8_t supply);
+	void trickleEnable(uint8_t path);
+	void trickleDisable();
+
+private:
+	friend class MAX31329;
+
+	static const uint8_t SLOTS = 8;
+	// Bit per register address: INT_EN..TIMER_CONFIG and TIMER_INIT..TRICKLE
+	static constexpr uint32_t STAGEABLE =
+		(0x1Ful << MAX31329_REG_INT_EN) | (0x07ul << MAX31329_REG_TIMER_INIT);
+	uint8_t mask[SLOTS];  // bits determined by staged changes
+	uint8_t value[SLOTS];
+	bool reload;          // timerConfigure() staged: a later TE=1 must reload TIMER_INIT
+
+	static int slotOf(uint8_t reg);
+};
+
+// Compact 32-bit time: seconds since 2000-01-01 00:00:00.
+// Covers 2000-01-01 .. 2136-02-07 (the RTC itself runs to 2199).
+struct MAX31329_PackedTime {
+	uint32_t seconds = 0;
+
+	static const int64_t EPOCH_2000 = 946684800;
+
+	int64_t toEpoch() const { return EPOCH_2000 + seconds; }
+	bool fromEpoch(int64_t epoch);
+	void toTime(MAX31329_Time &t) const;
+	bool fromTime(const MAX31329_Time &t);
+};
+
+// Registers 0x00-0x19 captured by one burst read (see MAX31329::snapshot)
+#define MAX31329_SNAPSHOT_REGS (MAX31329_REG_TRICKLE + 1)
+
+struct MAX31329_Snapshot {
+	uint8_t status;      // flags latched since the previous STATUS read (now cleared)
+	uint8_t intEnable;
+	uint8_t rtcReset;
+	uint8_t config1;
+	uint8_t config2;
+	uint8_t timerConfig;
+	MAX31329_Time time;  // raw chip time, dayOfWeek as stored
+	int64_t epoch;       // the same instant as Unix seconds
+	MAX31329_Alarm1 alarm1;
+	MAX31329_Alarm2 alarm2;
+	bool alarm1Valid;    // false when the mask pattern is not a datasheet mode
+	bool alarm2Valid;
+	uint8_t timerCount;
+	uint8_t timerInit;
+	uint8_t powerMgmt;
+	uint8_t trickle;
+	uint8_t regs[MAX31329_SNAPSHOT_REGS]; // raw bytes, indexed by register address
+};
+
+// Monotonic microsecond source used for interpolated time
+typedef int64_t (*MAX31329_MicrosFn)();
+
 class MAX31329 {
 public:
 	MAX31329();
@@ -49,6 +186,7 @@ public:
 	// Direct time access - read/write updates this
 	MAX31329_Time t;
 
+#if MAX31329_BUS_WIRE
 	// Initialize with default Wire and custom pins (most common case)
 	bool begin(int sdaPin, int sclPin, uint32_t frequency = 400000U);
 	
@@ -63,10 +201,46 @@ public:
 		int sdaPin = -1,
 		int sclPin = -1,
 		uint32_t frequency = 400000U);
+#endif
+
+	// Attach an already configured bus policy (see MAX31329_bus.h)
+	bool begin(const MAX31329_Bus &bus);
+
+	// 7-bit I2C address used by the Wire backend (default 0x68). Call before
+	// begin(), or at any time to retarget. Other backends carry the address
+	// in their own configuration.
+	void setAddress(uint8_t address);
+	uint8_t address() const { return i2cAddress; }
 
 	// Connectivity check (simple read of STATUS)
 	bool isConnected();
 
+	// Why the last bus transfer failed (MAX31329_OK after a success). Every
+	// driver call ends in readBytes()/writeBytes(), so this also explains a
+	// false from any of them.
+	MAX31329_Error lastError() const { return lastErr; }
+
+	// Bounded-latency transfers. A failed transfer is retried up to retries
+	// times, after backoffUs doubling on each retry. A retry only starts if
+	// it can finish (backoff plus one bus timeout) within deadlineUs of the
+	// first attempt (0: no deadline); otherwise lastError() is
+	// MAX31329_ERR_DEADLINE. Default: no retries.
+	void setRetry(uint8_t retries, uint16_t backoffUs = 100, uint32_t deadlineUs = 0);
+	// Per-transfer bus timeout (Wire::setTimeOut or the i2c_master timeout)
+	void setBusTimeout(uint16_t ms);
+	// Run bus recovery (9 SCL clocks and a STOP) before retrying after a
+	// timeout, bus error or short read. The Wire backend needs the pins
+	// from begin(sda, scl) or the board's default SDA/SCL.
+	void setBusRecovery(bool enable) { autoRecover = enable; }
+	bool recoverBus();
+	// Chip-side I2C timeout (CFG1.I2C_TIMEOUT): the MAX31329 resets its own
+	// interface when the bus stalls mid-transfer
+	bool setI2cTimeout(bool enable);
+	// Longest a single readBytes()/writeBytes() can block with these settings
+	uint32_t worstCaseUs() const;
+	MAX31329_BusHealth busHealth() const { return health; }
+	void busHealthReset() { health = MAX31329_BusHealth(); }
+
 	// Primary time interface - reads/writes rtc.t
 	bool readTime();  // Updates rtc.t from RTC
 	bool writeTime(); // Writes rtc.t to RTC
@@ -79,12 +253,114 @@ public:
 	bool writeTime(int year, int month, int day, int hour, int minute, int second, int dayOfWeek = 0);
 	bool readTime(int &year, int &month, int &day, int &hour, int &minute, int &second, int &dayOfWeek);
 
+	// Epoch interface (RTC wall time taken as UTC). Converts the raw register
+	// block directly, no struct tm or mktime() involved.
+	bool readEpoch(int64_t &epoch);
+	bool writeEpoch(int64_t epoch);
+	// Millisecond write goes through writeTimePrecise() (waits up to ~1 s)
+	bool writeEpochMs(int64_t epochMs);
+	bool readTime(MAX31329_PackedTime &packed);
+	bool writeTime(const MAX31329_PackedTime &packed);
+
+	// Calendar helpers (proleptic Gregorian, UTC). dayOfWeek is derived
+	// from the date; millisecond is cleared.
+	static void epochToTime(int64_t epoch, MAX31329_Time &t);
+	static int64_t timeToEpoch(const MAX31329_Time &t);
+	// Days since 1970-01-01, month length, and division rounding toward
+	// minus infinity (b > 0), for the add-on modules' date arithmetic
+	static int32_t daysFromCivil(int year, unsigned month, unsigned day);
+	static uint8_t daysInMonth(int year, unsigned month);
+	static int64_t floorDiv(int64_t a, int64_t b);
+	// Register encoding helpers (packed BCD, 0..99)
+	static uint8_t binToBcd(uint8_t v);
+	static uint8_t bcdToBin(uint8_t v);
+
+	// Interpolated time: anchor the RTC against a local monotonic counter and
+	// serve readTime()/readEpochMs() from it, re-reading the chip only every
+	// resyncIntervalMs. Each chip read narrows the window in which the RTC
+	// second started, so timestamps carry millisecond resolution.
+	// driftPpm bounds the rate mismatch between the RTC and the local counter.
+	bool enableFastTime(uint32_t resyncIntervalMs = 60000U, uint32_t driftPpm = 100U);
+	void disableFastTime();
+	// Poll the time registers until the 1 Hz edge is pinned down (blocks up to timeoutMs)
+	bool syncToEdge(uint32_t timeoutMs = 1100U);
+	// Epoch milliseconds; errorMs receives the error bound. Without fast time
+	// this is a plain chip read with whole-second resolution.
+	bool readEpochMs(int64_t &epochMs, uint32_t *errorMs = nullptr);
+	// Replace the monotonic source (esp_timer on target, steady_clock on host)
+	void setMicrosSource(MAX31329_MicrosFn fn);
+
+	// Software trim: the RTC runs ahead of true time by
+	//   offsetUs + ppb * (T - atRtcEpochUs) / 1e9  microseconds
+	// at RTC time T (epoch microseconds). Once set, it is subtracted from
+	// readTime(), readEpoch() and readEpochMs(). MAX31329_DriftEstimator
+	// (MAX31329_drift.h) maintains it from reference observations. Writing
+	// the time clears it.
+	void setTrim(int64_t atRtcEpochUs, int64_t offsetUs, int32_t ppb);
+	void clearTrim();
+	bool trimEnabled() const { return trimOn; }
+	// RTC time (epoch microseconds) at which the trimmed clock reads
+	// epochUs, e.g. to program an alarm for a trimmed deadline
+	int64_t untrimUs(int64_t epochUs) const;
+
+	// Precise time setting: refEpochUs is the reference time (UTC epoch, microseconds)
+	// sampled at local time capturedAtUs (same clock as setMicrosSource). The burst
+	// write is timed so the RTC's next second rolls over in phase with the reference;
+	// the call waits for that boundary (up to ~1 s), in delay() but for the last
+	// MAX31329_PRECISE_SPIN_US. If residualUs is given, the call then polls across
+	// the following edge (another ~1 s) and reports the measured RTC-minus-reference
+	// offset, with its uncertainty in residualErrUs.
+	bool writeTimePrecise(int64_t refEpochUs, int64_t capturedAtUs,
+		int32_t *residualUs = nullptr, uint32_t *residualErrUs = nullptr);
+
 	// Status / interrupts
 	bool readStatus(uint8_t &status);
 	bool clearStatus(); // read STATUS to clear latched flags
 	bool enableInterrupts(uint8_t mask);
 	bool disableInterrupts(uint8_t mask);
 
+	// Typed field access (MAX31329_fields.h). writeFields<> folds all values
+	// at compile time into one masked change per register and commits them
+	// like a transaction: a single read-modify-write per register (none when
+	// every bit is set or the shadow holds it), adjacent registers in one burst.
+	//   rtc.writeFields<MAX31329_Set<MAX31329_FIELD_CLKO_HZ, 3>,
+	//                   MAX31329_Set<MAX31329_FIELD_ENCLKO, 1>>();
+	template <typename... Sets> bool writeFields(size_t *transfers = nullptr) {
+		static_assert(sizeof...(Sets) > 0, "no fields given");
+		MAX31329_Transaction tx;
+		tx.set<Sets...>();
+		return commit(tx, transfers);
+	}
+	// Runtime value, truncated to the field width like the classic setters
+	template <typename Field> bool writeField(uint8_t value) {
+		MAX31329_Transaction tx;
+		if (!tx.setField<Field>(value)) return false;
+		return commit(tx);
+	}
+	// Served from the shadow cache when possible
+	template <typename Field> bool readField(uint8_t &value) {
+		uint8_t r;
+		if (!readReg(Field::reg, r)) return false;
+		value = Field::decode(r);
+		return true;
+	}
+
+	// Full device state in one 26-byte burst (0x00-0x19). The time registers
+	// latch on the START condition, so status, time, alarms and timer are
+	// from the same instant. Reading STATUS clears its flags. With verify, a
+	// 1-byte SECONDS read afterwards must show the same or the next second,
+	// otherwise the burst is repeated once (guards against a corrupted transfer).
+	bool snapshot(MAX31329_Snapshot &snap, bool verify = false);
+
+	// Alarms: each call is a single burst over 0x0D-0x12 (Alarm1) or
+	// 0x13-0x15 (Alarm2). Interrupts are enabled separately (A1IE/A2IE).
+	bool setAlarm1(const MAX31329_Alarm1 &alarm);
+	bool setAlarm2(const MAX31329_Alarm2 &alarm);
+	// Decode the programmed alarm; false on bus error or a mask pattern
+	// the datasheet does not list
+	bool readAlarm1(MAX31329_Alarm1 &alarm);
+	bool readAlarm2(MAX31329_Alarm2 &alarm);
+
 	// RTC oscillator control
 	bool startRTC();
 	bool stopRTC();
@@ -117,6 +393,29 @@ public:
 	bool trickleEnable(uint8_t path);
 	bool trickleDisable();
 
+	// Config register shadow cache (INT_EN, CFG1, CFG2, TIMER_CONFIG, PWR_MGMT, TRICKLE)
+	// Opt-in: enable before begin() to load it there. Control calls then skip the
+	// read half of their read-modify-write. Any write that sets SWRST drops it;
+	// invalidate or resync after a power loss so it matches the device again.
+	void setShadowCache(bool enable);
+	bool shadowResync();     // reload all shadowed registers (two burst reads)
+	void shadowInvalidate(); // drop shadow, next access reads the device
+	MAX31329_ShadowStats shadowStats() const;
+	void shadowStatsReset();
+
+	// Apply a staged transaction. Each register block costs at most one burst
+	// read (only for partially staged registers the shadow cannot supply) and
+	// the fewest burst writes that cover the staged registers.
+	// transfers (optional) receives the number of I2C transactions issued.
+	bool commit(const MAX31329_Transaction &tx, size_t *transfers = nullptr);
+
+#if KODE_MAX31329_STATS
+	// I2C usage per API call; copy out periodically and reset
+	void statsSnapshot(MAX31329_Stats &out) const;
+	void statsReset();
+	static const char *opName(MAX31329_Op op);
+#endif
+
 	// NVRAM access
 	bool readRam(uint8_t offset, uint8_t *buffer, size_t length);
 	bool writeRam(uint8_t offset, const uint8_t *buffer, size_t length);
@@ -126,10 +425,83 @@ public:
 	bool writeBytes(uint8_t reg, const uint8_t *buffer, size_t length);
 
 private:
-	TwoWire *wireBus;
+	MAX31329_Bus bus;
+	uint8_t i2cAddress;
 
-	static uint8_t binToBcd(uint8_t v);
-	static uint8_t bcdToBin(uint8_t v);
+	// Retry policy and bus health
+	MAX31329_Error lastErr;
+	uint8_t retryCount;
+	uint16_t retryBackoffUs;
+	uint32_t retryDeadlineUs;
+	uint16_t busTimeoutMs;
+	bool autoRecover;
+	MAX31329_BusHealth health;
+	bool transfer(uint8_t reg, uint8_t *in, const uint8_t *out, size_t length);
+
+	// Shadow cache state, one slot per shadowed register
+	static const uint8_t SHADOW_SLOTS = 6;
+	bool shadowEnabled;
+	uint8_t shadowValid; // bit per slot
+	uint8_t shadowRegs[SHADOW_SLOTS];
+	MAX31329_ShadowStats shadowCounters;
+
+#if KODE_MAX31329_STATS
+	// Attributes bus traffic to the outermost public call in progress
+	class StatsScope {
+	public:
+		StatsScope(MAX31329 &rtc, MAX31329_Op op);
+		~StatsScope();
+	private:
+		MAX31329 &rtc;
+		MAX31329_Op prevOp;
+		uint32_t startUs;
+	};
+	MAX31329_Op statsOp;
+	MAX31329_Stats stats;
+	void statsRecord(size_t length, bool ok);
+#endif
+
+	// Interpolated time state. The anchor says RTC second fastEpoch began at a
+	// local time inside [fastLo, fastHi] (microseconds of microsFn).
+	MAX31329_MicrosFn microsFn;
+	bool fastEnabled;
+	bool fastValid;
+	uint32_t fastResyncMs;
+	uint32_t fastDriftPpm;
+	int64_t fastEpoch;
+	int64_t fastLo;
+	int64_t fastHi;
+	int64_t fastSyncUs; // local time of the last chip read
+	uint8_t fastWday;   // day of week at fastEpoch
+
+	// Software trim (see setTrim)
+	bool trimOn;
+	int64_t trimAtUs;
+	int64_t trimOffsetUs;
+	int32_t trimPpb;
+	int64_t trimUs(int64_t rtcEpochUs) const;
+
+	// Raw (untrimmed) RTC time at local time localUs, with its error bound
+	friend class MAX31329_DriftEstimator;
+	bool rawSample(int64_t &rtcEpochUs, int64_t &localUs, uint32_t &errorUs);
+
+	void waitUntil(int64_t localUs);
+
+	bool fastObserve();
+	int64_t fastErrorUs(int64_t now) const;
+	void fastToTm(int64_t epochSec, struct tm &tm) const;
+
+	static int shadowSlot(uint8_t reg);
+	void shadowUpdate(uint8_t reg, const uint8_t *buffer, size_t length, bool valid);
+	bool readReg(uint8_t reg, uint8_t &value);
+	bool commitBlock(const MAX31329_Transaction &tx, uint8_t firstReg, uint8_t count, size_t &transfers,
+		uint8_t *lastValue = nullptr);
+
+	static int64_t regsToEpoch(const uint8_t *regs);
+	static void regsToTm(const uint8_t *regs, struct tm &tm);
+	static bool decodeAlarm1(const uint8_t *regs, bool century, MAX31329_Alarm1 &alarm);
+	static bool decodeAlarm2(const uint8_t *regs, MAX31329_Alarm2 &alarm);
+	static bool epochToRegs(int64_t epoch, uint8_t *regs);
 };
 
 #endif // KODE_MAX31329_H